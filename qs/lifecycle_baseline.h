@@ -0,0 +1,385 @@
+// MIT License
+
+// Copyright (c) 2025 Jose Sa
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#ifndef QS_LIFECYCLE_BASELINE_H
+#define QS_LIFECYCLE_BASELINE_H
+
+
+#include <qs/lifecycle_tracker.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <vector>
+
+
+QS_NAMESPACE_BEGIN
+
+// A type of a counter dump written by qs::lifecycle_registry::to_json()
+struct lifecycle_baseline_entry
+{
+    std::string        name;
+    size_t             uuid;
+    bool               mt;
+    lifecycle_counters counters;
+
+    // Identifier of the same counters across dumps, "name#uuid" with " (mt)" for thread-safe ones
+    std::string key() const { return name + "#" + std::to_string(uuid) + (mt ? " (mt)" : ""); }
+};
+
+// A counter that grew beyond the allowed threshold between two dumps
+struct lifecycle_regression
+{
+    std::string     key;
+    lifecycle_event event;
+    size_t          baseline;
+    size_t          current;
+    bool            new_type; // missing from the baseline, compared with zero counters
+};
+
+// Thresholds for qs::lifecycle_baseline::compare
+struct lifecycle_compare_options
+{
+    // Allowed relative growth, e.g. 0.1 accepts up to 10% more events
+    double max_ratio = 0.0;
+    // Growth that is always accepted, to ignore noise in small counts
+    size_t min_delta = 0;
+    // Counters to compare, constructions, copies and moves by default
+    lifecycle_event_mask events = lifecycle_event_bit(lifecycle_event::Constructor) |
+                                  lifecycle_event_bit(lifecycle_event::CopyConstructor) |
+                                  lifecycle_event_bit(lifecycle_event::MoveConstructor) |
+                                  lifecycle_event_bit(lifecycle_event::CopyAssignment);
+    // Skip the types missing from the baseline instead of comparing them with zero counters
+    bool ignore_new_types = false;
+};
+
+
+namespace intl
+{
+    // Reader for the JSON written by qs::lifecycle_registry::to_json(). Unknown keys are
+    // skipped, so dumps of later versions can still be compared.
+    class lifecycle_json_reader
+    {
+    public:
+        explicit lifecycle_json_reader(std::string const& text)
+            : text_{text}
+        {}
+
+        bool read_dump(std::vector<lifecycle_baseline_entry>& out)
+        {
+            if(!expect_('{'))
+                return false;
+            if(!consume_('}'))
+            {
+                do
+                {
+                    std::string key;
+                    if(!read_string_(key) || !expect_(':'))
+                        return false;
+                    if(key == "types" ? !read_types_(out) : !skip_value_(0))
+                        return false;
+                } while(consume_(','));
+                if(!expect_('}'))
+                    return false;
+            }
+            skip_ws_();
+            return pos_ == text_.size();
+        }
+
+    private:
+        std::string const& text_;
+        size_t             pos_ = 0;
+
+        void skip_ws_()
+        {
+            while(pos_ < text_.size() && std::strchr(" \t\r\n", text_[pos_]) != nullptr)
+                ++pos_;
+        }
+
+        bool consume_(char c)
+        {
+            skip_ws_();
+            if(pos_ < text_.size() && text_[pos_] == c)
+            {
+                ++pos_;
+                return true;
+            }
+            return false;
+        }
+
+        bool expect_(char c) { return consume_(c); }
+
+        bool consume_word_(char const* word)
+        {
+            skip_ws_();
+            size_t const len = std::strlen(word);
+            if(text_.compare(pos_, len, word) != 0)
+                return false;
+            pos_ += len;
+            return true;
+        }
+
+        bool read_types_(std::vector<lifecycle_baseline_entry>& out)
+        {
+            if(!expect_('['))
+                return false;
+            if(consume_(']'))
+                return true;
+            do
+            {
+                lifecycle_baseline_entry entry{};
+                if(!read_entry_(entry))
+                    return false;
+                out.push_back(entry);
+            } while(consume_(','));
+            return expect_(']');
+        }
+
+        bool read_entry_(lifecycle_baseline_entry& entry)
+        {
+            static char const* const fields[] = {"constructor",     "copy_constructor",
+                                                 "move_constructor", "copy_assignment",
+                                                 "move_assignment",  "destructor"};
+            size_t* const            counters[] = {
+                &entry.counters.constructor,     &entry.counters.copy_constructor,
+                &entry.counters.move_constructor, &entry.counters.copy_assignment,
+                &entry.counters.move_assignment,  &entry.counters.destructor};
+
+            if(!expect_('{'))
+                return false;
+            if(consume_('}'))
+                return true;
+            do
+            {
+                std::string key;
+                if(!read_string_(key) || !expect_(':'))
+                    return false;
+
+                bool ok = false;
+                if(key == "name")
+                    ok = read_string_(entry.name);
+                else if(key == "uuid")
+                    ok = read_number_(entry.uuid);
+                else if(key == "mt")
+                    ok = read_bool_(entry.mt);
+                else
+                {
+                    size_t const field = static_cast<size_t>(
+                        std::find(std::begin(fields), std::end(fields), key) - std::begin(fields));
+                    ok = field < 6 ? read_number_(*counters[field]) : skip_value_(0);
+                }
+                if(!ok)
+                    return false;
+            } while(consume_(','));
+            return expect_('}');
+        }
+
+        bool read_number_(size_t& value)
+        {
+            skip_ws_();
+            size_t const start = pos_;
+            value              = 0;
+            while(pos_ < text_.size() && text_[pos_] >= '0' && text_[pos_] <= '9')
+                value = value * 10 + static_cast<size_t>(text_[pos_++] - '0');
+            return pos_ != start;
+        }
+
+        bool read_bool_(bool& value)
+        {
+            if(consume_word_("true"))
+                value = true;
+            else if(consume_word_("false"))
+                value = false;
+            else
+                return false;
+            return true;
+        }
+
+        bool read_string_(std::string& out)
+        {
+            if(!expect_('"'))
+                return false;
+            out.clear();
+            while(pos_ < text_.size())
+            {
+                char const c = text_[pos_++];
+                if(c == '"')
+                    return true;
+                if(c != '\\')
+                {
+                    out.push_back(c);
+                    continue;
+                }
+                if(pos_ >= text_.size())
+                    return false;
+                char const e = text_[pos_++];
+                switch(e)
+                {
+                    case 'b': out.push_back('\b'); break;
+                    case 'f': out.push_back('\f'); break;
+                    case 'n': out.push_back('\n'); break;
+                    case 'r': out.push_back('\r'); break;
+                    case 't': out.push_back('\t'); break;
+                    case 'u':
+                    {
+                        if(pos_ + 4 > text_.size())
+                            return false;
+                        unsigned long const code =
+                            std::strtoul(text_.substr(pos_, 4).c_str(), nullptr, 16);
+                        out.push_back(code < 0x80 ? static_cast<char>(code) : '?');
+                        pos_ += 4;
+                        break;
+                    }
+                    default: out.push_back(e); break;
+                }
+            }
+            return false;
+        }
+
+        bool skip_value_(int depth)
+        {
+            skip_ws_();
+            if(pos_ >= text_.size() || depth > 64)
+                return false;
+            char const c = text_[pos_];
+            if(c == '"')
+            {
+                std::string ignored;
+                return read_string_(ignored);
+            }
+            if(c == '{' || c == '[')
+            {
+                char const close = c == '{' ? '}' : ']';
+                ++pos_;
+                if(consume_(close))
+                    return true;
+                do
+                {
+                    if(c == '{')
+                    {
+                        std::string key;
+                        if(!read_string_(key) || !expect_(':'))
+                            return false;
+                    }
+                    if(!skip_value_(depth + 1))
+                        return false;
+                } while(consume_(','));
+                return expect_(close);
+            }
+            if(consume_word_("true") || consume_word_("false") || consume_word_("null"))
+                return true;
+            size_t const start = pos_;
+            while(pos_ < text_.size() && std::strchr("+-.eE0123456789", text_[pos_]) != nullptr)
+                ++pos_;
+            return pos_ != start;
+        }
+    };
+} // namespace intl
+
+
+// Counter dumps used as baselines, to catch copy and construction regressions in CI
+class lifecycle_baseline
+{
+public:
+    // Parse a dump written by qs::lifecycle_registry::to_json()
+    static bool parse(std::string const& json, std::vector<lifecycle_baseline_entry>& out)
+    {
+        out.clear();
+        return intl::lifecycle_json_reader{json}.read_dump(out);
+    }
+
+    // Load and parse a dump file
+    static bool load(char const* path, std::vector<lifecycle_baseline_entry>& out)
+    {
+        std::FILE* const file = std::fopen(path, "rb");
+        if(file == nullptr)
+            return false;
+        std::string json;
+        char        buffer[4096];
+        for(size_t n; (n = std::fread(buffer, 1, sizeof(buffer), file)) > 0;)
+            json.append(buffer, n);
+        std::fclose(file);
+        return parse(json, out);
+    }
+
+    // Name of the counter of an event, as used in the dumps
+    static char const* counter_name(lifecycle_event event) noexcept
+    {
+        static char const* const names[] = {"constructor",     "copy_constructor",
+                                            "move_constructor", "copy_assignment",
+                                            "move_assignment",  "destructor"};
+        return names[static_cast<size_t>(event)];
+    }
+
+    // Counters that grew beyond the thresholds. A type missing from the baseline is compared
+    // with zero counters, so a new type that copies is reported unless ignore_new_types is set.
+    static std::vector<lifecycle_regression>
+    compare(std::vector<lifecycle_baseline_entry> const& baseline,
+            std::vector<lifecycle_baseline_entry> const& current,
+            lifecycle_compare_options const&              options = {})
+    {
+        std::vector<lifecycle_regression> res;
+        for(lifecycle_baseline_entry const& cur : current)
+        {
+            std::string const key = cur.key();
+            auto const        base =
+                std::find_if(baseline.begin(), baseline.end(),
+                             [&key](lifecycle_baseline_entry const& e) { return e.key() == key; });
+            bool const new_type = base == baseline.end();
+            if(new_type && options.ignore_new_types)
+                continue;
+
+            for(size_t i = 0; i < 6; ++i)
+            {
+                auto const event = static_cast<lifecycle_event>(i);
+                if(!(options.events & lifecycle_event_bit(event)))
+                    continue;
+                size_t const before = new_type ? 0 : get_(base->counters, event);
+                size_t const after  = get_(cur.counters, event);
+                if(after > before && after - before > options.min_delta &&
+                   static_cast<double>(after) >
+                       static_cast<double>(before) * (1.0 + options.max_ratio))
+                    res.push_back({key, event, before, after, new_type});
+            }
+        }
+        return res;
+    }
+
+private:
+    static size_t get_(lifecycle_counters const& cnts, lifecycle_event event) noexcept
+    {
+        size_t const values[] = {cnts.constructor,     cnts.copy_constructor,
+                                 cnts.move_constructor, cnts.copy_assignment,
+                                 cnts.move_assignment,  cnts.destructor};
+        return values[static_cast<size_t>(event)];
+    }
+};
+
+QS_NAMESPACE_END
+
+
+#endif // QS_LIFECYCLE_BASELINE_H
@@ -0,0 +1,661 @@
+// MIT License
+
+// Copyright (c) 2025 Jose Sa
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#ifndef QS_LIFECYCLE_CONTAINERS_H
+#define QS_LIFECYCLE_CONTAINERS_H
+
+
+#include <qs/lifecycle_tracker.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+QS_NAMESPACE_BEGIN
+
+// Growth of a container: its reallocations, the element copies and moves they caused, and the
+// largest size against the largest capacity
+struct lifecycle_container_stats
+{
+    size_t reallocations;    // vector buffers, deque maps or unordered_map bucket arrays replaced
+    size_t relocated_copies; // elements copied into a new buffer
+    size_t relocated_moves;  // elements moved into a new buffer
+    size_t peak_size;
+    size_t peak_capacity;    // elements for vector and deque, buckets for unordered_map
+
+    bool operator==(lifecycle_container_stats const& rhs) const noexcept
+    {
+        return reallocations == rhs.reallocations && relocated_copies == rhs.relocated_copies &&
+               relocated_moves == rhs.relocated_moves && peak_size == rhs.peak_size &&
+               peak_capacity == rhs.peak_capacity;
+    }
+    bool operator!=(lifecycle_container_stats const& rhs) const noexcept { return !(*this == rhs); }
+};
+
+
+namespace intl
+{
+    // Element types that are trackers, whose counters are printed with the container stats
+    template<class T>
+    struct tracked_element : std::false_type
+    {};
+
+    template<class T, size_t Uuid>
+    struct tracked_element<lifecycle_tracker<T, Uuid>> : std::true_type
+    {
+        static constexpr size_t uuid = Uuid;
+    };
+
+    template<class T, size_t Uuid>
+    struct tracked_element<lifecycle_tracker_mt<T, Uuid>> : std::true_type
+    {
+        static constexpr size_t uuid = Uuid;
+    };
+
+    template<class T, size_t Uuid>
+    struct tracked_element<tracked<T, Uuid>> : std::true_type
+    {
+        static constexpr size_t uuid = Uuid;
+    };
+
+    template<class T, size_t Uuid>
+    struct tracked_element<tracked_mt<T, Uuid>> : std::true_type
+    {
+        static constexpr size_t uuid = Uuid;
+    };
+
+    // Whether relocating T into a new buffer moves it, as std::move_if_noexcept decides
+    template<class T>
+    struct relocates_by_move
+        : std::integral_constant<bool, std::is_nothrow_move_constructible<T>::value ||
+                                           !std::is_copy_constructible<T>::value>
+    {};
+
+    // Stats of one container, updated by the adapters after each operation that can grow it
+    class lifecycle_container_recorder
+    {
+    public:
+        lifecycle_container_stats const& stats() const noexcept { return stats_; }
+
+        void reset() noexcept { stats_ = lifecycle_container_stats{}; }
+
+        // A new buffer or bucket array, and the elements relocated into it
+        void on_reallocation(size_t relocated, bool by_move) noexcept
+        {
+            ++stats_.reallocations;
+            (by_move ? stats_.relocated_moves : stats_.relocated_copies) += relocated;
+        }
+
+        void on_size(size_t size, size_t capacity) noexcept
+        {
+            stats_.peak_size     = (std::max)(stats_.peak_size, size);
+            stats_.peak_capacity = (std::max)(stats_.peak_capacity, capacity);
+        }
+
+    private:
+        lifecycle_container_stats stats_{};
+    };
+
+    template<class T>
+    std::string element_name_(std::true_type)
+    {
+        return T::get_type_name();
+    }
+
+    template<class T>
+    std::string element_name_(std::false_type)
+    {
+        return demangler<T>::get();
+    }
+
+    template<class T>
+    void append_element_counters_(std::string& out, std::true_type)
+    {
+        format_counters(out, T::get_counters(), T::get_type_name(), tracked_element<T>::uuid);
+    }
+
+    template<class T>
+    void append_element_counters_(std::string&, std::false_type)
+    {}
+
+    // Print the stats of a container of T, then the counters of T when it is tracked
+    template<class T>
+    void print_container_stats(lifecycle_sink* sink, char const* container,
+                               lifecycle_container_stats const& stats)
+    {
+        if(sink == nullptr)
+            return;
+        std::string out = std::string{"Lifecycle "} + container + " [element: " +
+                          element_name_<T>(tracked_element<T>{}) + "]\n";
+        out += " * reallocations (copies/moves) : " + std::to_string(stats.reallocations) + " (" +
+               std::to_string(stats.relocated_copies) + "/" +
+               std::to_string(stats.relocated_moves) + ")\n";
+        out += " * peak size (capacity)         : " + std::to_string(stats.peak_size) + " (" +
+               std::to_string(stats.peak_capacity) + ")\n";
+        append_element_counters_<T>(out, tracked_element<T>{});
+        lifecycle_log_line line{sink, true};
+        line.str() += out;
+    }
+
+    // Reports the growth of the wrapped container operation when it completes
+    template<class Container>
+    class growth_scope
+    {
+    public:
+        explicit growth_scope(Container& container) noexcept
+            : container_(container),
+              capacity_(container.capacity_()),
+              size_(container.size())
+        {}
+
+        ~growth_scope() { container_.after_growth_(capacity_, size_); }
+
+        growth_scope(growth_scope const&)            = delete;
+        growth_scope& operator=(growth_scope const&) = delete;
+
+    private:
+        Container& container_;
+        size_t     capacity_;
+        size_t     size_;
+    };
+
+    struct lifecycle_slot_counts
+    {
+        size_t slots; // live element slots
+        size_t maps;  // maps allocated so far
+    };
+
+    // Counts the element slots and the maps that a deque allocates, as it exposes no capacity
+    template<class T, class Elem>
+    class lifecycle_slot_allocator
+    {
+    public:
+        using value_type = T;
+
+        template<class U>
+        struct rebind
+        {
+            using other = lifecycle_slot_allocator<U, Elem>;
+        };
+
+        lifecycle_slot_allocator() noexcept = default;
+
+        explicit lifecycle_slot_allocator(lifecycle_slot_counts* counts) noexcept
+            : counts_(counts)
+        {}
+
+        template<class U>
+        lifecycle_slot_allocator(lifecycle_slot_allocator<U, Elem> const& other) noexcept
+            : counts_(other.counts_)
+        {}
+
+        T* allocate(size_t n)
+        {
+            T* const p = std::allocator<T>{}.allocate(n);
+            if(counts_ != nullptr && std::is_same<T, Elem>::value)
+                counts_->slots += n;
+            else if(counts_ != nullptr && std::is_same<T, Elem*>::value)
+                ++counts_->maps;
+            return p;
+        }
+
+        void deallocate(T* p, size_t n) noexcept
+        {
+            if(counts_ != nullptr && std::is_same<T, Elem>::value)
+                counts_->slots -= n;
+            std::allocator<T>{}.deallocate(p, n);
+        }
+
+        // The memory comes from std::allocator, so any instance can free it. The counts move with
+        // the blocks when lifecycle_deque swaps them.
+        template<class U>
+        bool operator==(lifecycle_slot_allocator<U, Elem> const&) const noexcept
+        {
+            return true;
+        }
+
+        template<class U>
+        bool operator!=(lifecycle_slot_allocator<U, Elem> const&) const noexcept
+        {
+            return false;
+        }
+
+    private:
+        template<class, class>
+        friend class lifecycle_slot_allocator;
+
+        lifecycle_slot_counts* counts_ = nullptr;
+    };
+} // namespace intl
+
+
+// std::vector that records its reallocations, the elements they relocated, and its peak size
+// and capacity. Operations through a reference to the std::vector base are not recorded.
+template<class T, class Allocator = std::allocator<T>>
+class lifecycle_vector : public std::vector<T, Allocator>
+{
+    using base = std::vector<T, Allocator>;
+
+public:
+    using typename base::const_iterator;
+    using typename base::iterator;
+    using typename base::size_type;
+    using typename base::value_type;
+
+    using base::base;
+
+    lifecycle_vector() = default;
+
+    // Stats of this vector
+    lifecycle_container_stats const& stats() const noexcept { return recorder_.stats(); }
+
+    void reset_stats() noexcept { recorder_.reset(); }
+
+    // Print the stats, then the counters of the element type when it is a tracker
+    void print_stats(lifecycle_sink* sink = lifecycle_sinks::stderr_sink()) const
+    {
+        intl::print_container_stats<T>(sink, "vector", stats());
+    }
+
+    void push_back(T const& value)
+    {
+        scope const growth{*this};
+        base::push_back(value);
+    }
+
+    void push_back(T&& value)
+    {
+        scope const growth{*this};
+        base::push_back(std::move(value));
+    }
+
+    template<class... Args>
+    T& emplace_back(Args&&... args)
+    {
+        scope const growth{*this};
+        base::emplace_back(std::forward<Args>(args)...);
+        return base::back();
+    }
+
+    template<class... Args>
+    iterator emplace(const_iterator pos, Args&&... args)
+    {
+        scope const growth{*this};
+        return base::emplace(pos, std::forward<Args>(args)...);
+    }
+
+    template<class... Args>
+    iterator insert(const_iterator pos, Args&&... args)
+    {
+        scope const growth{*this};
+        return base::insert(pos, std::forward<Args>(args)...);
+    }
+
+    iterator insert(const_iterator pos, std::initializer_list<T> values)
+    {
+        scope const growth{*this};
+        return base::insert(pos, values);
+    }
+
+    template<class... Args>
+    void assign(Args&&... args)
+    {
+        scope const growth{*this};
+        base::assign(std::forward<Args>(args)...);
+    }
+
+    void assign(std::initializer_list<T> values)
+    {
+        scope const growth{*this};
+        base::assign(values);
+    }
+
+    template<class... Args>
+    void resize(Args&&... args)
+    {
+        scope const growth{*this};
+        base::resize(std::forward<Args>(args)...);
+    }
+
+    void reserve(size_type capacity)
+    {
+        scope const growth{*this};
+        base::reserve(capacity);
+    }
+
+    void shrink_to_fit()
+    {
+        scope const growth{*this};
+        base::shrink_to_fit();
+    }
+
+private:
+    using scope = intl::growth_scope<lifecycle_vector>;
+    friend scope;
+
+    size_t capacity_() const noexcept { return base::capacity(); }
+
+    void after_growth_(size_t capacity, size_t size) noexcept
+    {
+        // the first buffer relocates nothing and is not a reallocation
+        if(base::capacity() != capacity && capacity != 0)
+            recorder_.on_reallocation(size, intl::relocates_by_move<T>::value);
+        recorder_.on_size(base::size(), base::capacity());
+    }
+
+    intl::lifecycle_container_recorder recorder_;
+};
+
+
+// std::deque that records the reallocations of its map, which relocate no element, and its peak
+// size and capacity. The capacity is the number of element slots in its allocated blocks.
+template<class T>
+class lifecycle_deque
+    : private intl::lifecycle_slot_counts,
+      public std::deque<T, intl::lifecycle_slot_allocator<T, T>>
+{
+    using counts = intl::lifecycle_slot_counts;
+    using base   = std::deque<T, intl::lifecycle_slot_allocator<T, T>>;
+
+public:
+    using typename base::const_iterator;
+    using typename base::iterator;
+    using typename base::size_type;
+    using typename base::value_type;
+
+    lifecycle_deque()
+        : counts{}, base(typename base::allocator_type{static_cast<counts*>(this)})
+    {}
+
+    lifecycle_deque(std::initializer_list<T> values)
+        : lifecycle_deque()
+    {
+        assign(values);
+    }
+
+    lifecycle_deque(lifecycle_deque const& other)
+        : lifecycle_deque()
+    {
+        assign(other.begin(), other.end());
+    }
+
+    // Takes the blocks of other with their slot counts and stats, and moves no element
+    lifecycle_deque(lifecycle_deque&& other)
+        : lifecycle_deque()
+    {
+        swap(other);
+    }
+
+    lifecycle_deque& operator=(lifecycle_deque const& other)
+    {
+        if(this != &other)
+            assign(other.begin(), other.end());
+        return *this;
+    }
+
+    lifecycle_deque& operator=(lifecycle_deque&& other)
+    {
+        if(this != &other)
+        {
+            lifecycle_deque moved{std::move(other)};
+            swap(moved);
+        }
+        return *this;
+    }
+
+    // Swaps the blocks, and the slot counts and stats that describe them
+    void swap(lifecycle_deque& other) noexcept
+    {
+        base::swap(other);
+        std::swap(static_cast<counts&>(*this), static_cast<counts&>(other));
+        std::swap(recorder_, other.recorder_);
+    }
+
+    // Stats of this deque
+    lifecycle_container_stats const& stats() const noexcept { return recorder_.stats(); }
+
+    void reset_stats() noexcept { recorder_.reset(); }
+
+    // Print the stats, then the counters of the element type when it is a tracker
+    void print_stats(lifecycle_sink* sink = lifecycle_sinks::stderr_sink()) const
+    {
+        intl::print_container_stats<T>(sink, "deque", stats());
+    }
+
+    template<class... Args>
+    void push_back(Args&&... args)
+    {
+        scope const growth{*this};
+        base::push_back(std::forward<Args>(args)...);
+    }
+
+    template<class... Args>
+    void push_front(Args&&... args)
+    {
+        scope const growth{*this};
+        base::push_front(std::forward<Args>(args)...);
+    }
+
+    template<class... Args>
+    T& emplace_back(Args&&... args)
+    {
+        scope const growth{*this};
+        base::emplace_back(std::forward<Args>(args)...);
+        return base::back();
+    }
+
+    template<class... Args>
+    T& emplace_front(Args&&... args)
+    {
+        scope const growth{*this};
+        base::emplace_front(std::forward<Args>(args)...);
+        return base::front();
+    }
+
+    template<class... Args>
+    iterator emplace(const_iterator pos, Args&&... args)
+    {
+        scope const growth{*this};
+        return base::emplace(pos, std::forward<Args>(args)...);
+    }
+
+    template<class... Args>
+    iterator insert(const_iterator pos, Args&&... args)
+    {
+        scope const growth{*this};
+        return base::insert(pos, std::forward<Args>(args)...);
+    }
+
+    template<class... Args>
+    void assign(Args&&... args)
+    {
+        scope const growth{*this};
+        base::assign(std::forward<Args>(args)...);
+    }
+
+    void assign(std::initializer_list<T> values)
+    {
+        scope const growth{*this};
+        base::assign(values);
+    }
+
+    template<class... Args>
+    void resize(Args&&... args)
+    {
+        scope const growth{*this};
+        base::resize(std::forward<Args>(args)...);
+    }
+
+    void shrink_to_fit()
+    {
+        scope const growth{*this};
+        base::shrink_to_fit();
+    }
+
+private:
+    using scope = intl::growth_scope<lifecycle_deque>;
+    friend scope;
+
+    size_t capacity_() const noexcept { return counts::maps; }
+
+    void after_growth_(size_t maps, size_t) noexcept
+    {
+        // the first map is not a reallocation
+        for(size_t i = (std::max)(maps, size_t{1}); i < counts::maps; ++i)
+            recorder_.on_reallocation(0, true);
+        recorder_.on_size(base::size(), counts::slots);
+    }
+
+    intl::lifecycle_container_recorder recorder_;
+};
+
+
+// std::unordered_map that records its rehashes, which relink nodes without relocating them, and
+// its peak size against its peak number of buckets
+template<class Key, class T, class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>,
+         class Allocator = std::allocator<std::pair<Key const, T>>>
+class lifecycle_unordered_map : public std::unordered_map<Key, T, Hash, KeyEqual, Allocator>
+{
+    using base = std::unordered_map<Key, T, Hash, KeyEqual, Allocator>;
+
+public:
+    using typename base::const_iterator;
+    using typename base::iterator;
+    using typename base::key_type;
+    using typename base::mapped_type;
+    using typename base::size_type;
+    using typename base::value_type;
+
+    using base::base;
+
+    lifecycle_unordered_map() = default;
+
+    // Stats of this map
+    lifecycle_container_stats const& stats() const noexcept { return recorder_.stats(); }
+
+    void reset_stats() noexcept { recorder_.reset(); }
+
+    // Print the stats, then the counters of the mapped type when it is a tracker
+    void print_stats(lifecycle_sink* sink = lifecycle_sinks::stderr_sink()) const
+    {
+        intl::print_container_stats<T>(sink, "unordered_map", stats());
+    }
+
+    template<class... Args>
+    auto insert(Args&&... args) -> decltype(std::declval<base&>().insert(std::forward<Args>(args)...))
+    {
+        scope const growth{*this};
+        return base::insert(std::forward<Args>(args)...);
+    }
+
+    std::pair<iterator, bool> insert(value_type const& value)
+    {
+        scope const growth{*this};
+        return base::insert(value);
+    }
+
+    void insert(std::initializer_list<value_type> values)
+    {
+        scope const growth{*this};
+        base::insert(values);
+    }
+
+    template<class... Args>
+    std::pair<iterator, bool> emplace(Args&&... args)
+    {
+        scope const growth{*this};
+        return base::emplace(std::forward<Args>(args)...);
+    }
+
+#if defined(__cpp_lib_unordered_map_try_emplace)
+    template<class... Args>
+    auto try_emplace(Args&&... args)
+        -> decltype(std::declval<base&>().try_emplace(std::forward<Args>(args)...))
+    {
+        scope const growth{*this};
+        return base::try_emplace(std::forward<Args>(args)...);
+    }
+
+    template<class... Args>
+    auto insert_or_assign(Args&&... args)
+        -> decltype(std::declval<base&>().insert_or_assign(std::forward<Args>(args)...))
+    {
+        scope const growth{*this};
+        return base::insert_or_assign(std::forward<Args>(args)...);
+    }
+#endif
+
+    T& operator[](key_type const& key)
+    {
+        scope const growth{*this};
+        return base::operator[](key);
+    }
+
+    T& operator[](key_type&& key)
+    {
+        scope const growth{*this};
+        return base::operator[](std::move(key));
+    }
+
+    void rehash(size_type buckets)
+    {
+        scope const growth{*this};
+        base::rehash(buckets);
+    }
+
+    void reserve(size_type count)
+    {
+        scope const growth{*this};
+        base::reserve(count);
+    }
+
+private:
+    using scope = intl::growth_scope<lifecycle_unordered_map>;
+    friend scope;
+
+    size_t capacity_() const noexcept { return base::bucket_count(); }
+
+    void after_growth_(size_t buckets, size_t size) noexcept
+    {
+        // rehashing an empty map only replaces the initial bucket array
+        if(base::bucket_count() != buckets && size != 0)
+            recorder_.on_reallocation(0, true);
+        recorder_.on_size(base::size(), base::bucket_count());
+    }
+
+    intl::lifecycle_container_recorder recorder_;
+};
+
+QS_NAMESPACE_END
+
+
+#endif // QS_LIFECYCLE_CONTAINERS_H
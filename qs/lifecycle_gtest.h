@@ -0,0 +1,216 @@
+// MIT License
+
+// Copyright (c) 2025 Jose Sa
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+
+
+#ifndef QS_LIFECYCLE_GTEST_H
+#define QS_LIFECYCLE_GTEST_H
+
+
+// Budgets of lifecycle events for GoogleTest. The block after the macro is counted in its own
+// qs::lifecycle_counter_context, so only the events of the calling thread inside the block are
+// measured, and they are added back to the enclosing counters afterwards.
+//
+//     using tracked_foo = qs::lifecycle_tracker<Foo>;
+//     EXPECT_LIFECYCLE_BUDGET(tracked_foo, {.copies = 0, .moves = 2})
+//     {
+//         hot_path(input);
+//     }
+//
+// Designated initializers need C++20; with C++14, set the fields of a qs::lifecycle_budget.
+// The tracker is the first macro argument, so use an alias when it has a uuid.
+
+#include <qs/lifecycle_tracker.h>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+
+QS_NAMESPACE_BEGIN
+
+// Upper bounds on the events of a block, `unlimited` ones are not checked
+struct lifecycle_budget
+{
+    static constexpr size_t unlimited = static_cast<size_t>(-1);
+
+    size_t constructions = unlimited; // constructors, copies and moves excluded
+    size_t copies        = unlimited; // copy constructions and assignments
+    size_t moves         = unlimited; // move constructions and assignments
+    size_t destructions  = unlimited;
+};
+
+
+namespace intl
+{
+    template<class T, size_t Uuid>
+    constexpr size_t tracker_uuid(lifecycle_tracker<T, Uuid> const*) noexcept
+    {
+        return Uuid;
+    }
+
+    template<class T, size_t Uuid>
+    constexpr size_t tracker_uuid(lifecycle_tracker_mt<T, Uuid> const*) noexcept
+    {
+        return Uuid;
+    }
+
+    template<class T, size_t Uuid>
+    constexpr size_t tracker_uuid(tracked<T, Uuid> const*) noexcept
+    {
+        return Uuid;
+    }
+
+    template<class T, size_t Uuid>
+    constexpr size_t tracker_uuid(tracked_mt<T, Uuid> const*) noexcept
+    {
+        return Uuid;
+    }
+
+    // Counts the block of a budget macro, which runs it once between start() and stop()
+    template<class Tracker>
+    class lifecycle_budget_scope
+    {
+    public:
+        explicit lifecycle_budget_scope(lifecycle_budget const& budget)
+            : budget_{budget}
+        {}
+
+        ~lifecycle_budget_scope() { stop(); }
+
+        lifecycle_budget_scope(lifecycle_budget_scope const&)            = delete;
+        lifecycle_budget_scope& operator=(lifecycle_budget_scope const&) = delete;
+
+        // A second call happens when the block was left with break, and ends the measure
+        void start()
+        {
+            if(started_)
+                return stop();
+            started_ = true;
+            scope_.reset(new lifecycle_counter_scope{context_});
+        }
+
+        bool running() const noexcept { return scope_ != nullptr; }
+
+        void stop()
+        {
+            if(scope_ == nullptr)
+                return;
+            counters_ = Tracker::get_counters();
+            scope_.reset();
+            context_.merge();
+            measured_ = true;
+        }
+
+        bool measured() const noexcept { return measured_; }
+
+        bool checked() const noexcept { return checked_; }
+
+        void check() noexcept { checked_ = true; }
+
+        lifecycle_counters const& counters() const noexcept { return counters_; }
+
+        bool ok() const noexcept
+        {
+            return within_(counters_.constructor, budget_.constructions) &&
+                   within_(copies_(), budget_.copies) && within_(moves_(), budget_.moves) &&
+                   within_(counters_.destructor, budget_.destructions);
+        }
+
+        // The measured events against the budget, then the counters of the block
+        std::string report() const
+        {
+            std::string out = "Lifecycle budget [type: " + Tracker::get_type_name() +
+                              ", uuid: " +
+                              std::to_string(tracker_uuid(static_cast<Tracker const*>(nullptr))) +
+                              "] exceeded\n";
+            line_(out, " * constructions : ", counters_.constructor, budget_.constructions);
+            line_(out, " * copies        : ", copies_(), budget_.copies);
+            line_(out, " * moves         : ", moves_(), budget_.moves);
+            line_(out, " * destructions  : ", counters_.destructor, budget_.destructions);
+            format_counters(out, counters_, Tracker::get_type_name(),
+                            tracker_uuid(static_cast<Tracker const*>(nullptr)));
+            return out;
+        }
+
+    private:
+        lifecycle_budget                         budget_;
+        lifecycle_counter_context                context_;
+        std::unique_ptr<lifecycle_counter_scope> scope_;
+        lifecycle_counters                       counters_{};
+        bool                                     started_  = false;
+        bool                                     measured_ = false;
+        bool                                     checked_  = false;
+
+        size_t copies_() const noexcept
+        {
+            return counters_.copy_constructor + counters_.copy_assignment;
+        }
+
+        size_t moves_() const noexcept
+        {
+            return counters_.move_constructor + counters_.move_assignment;
+        }
+
+        static bool within_(size_t value, size_t limit) noexcept
+        {
+            return limit == lifecycle_budget::unlimited || value <= limit;
+        }
+
+        static void line_(std::string& out, char const* name, size_t value, size_t limit)
+        {
+            if(limit == lifecycle_budget::unlimited)
+                return;
+            out += name + std::to_string(value) + " (budget " + std::to_string(limit) + ")";
+            out += value > limit ? ", over by " + std::to_string(value - limit) + "\n" : "\n";
+        }
+    };
+} // namespace intl
+
+QS_NAMESPACE_END
+
+
+#define QS_LIFECYCLE_BUDGET_(Tracker, on_failure, ...)                                             \
+    for(::QS_NAMESPACE::intl::lifecycle_budget_scope<Tracker> qs_lifecycle_budget_{__VA_ARGS__};   \
+        !qs_lifecycle_budget_.checked();)                                                          \
+        if(qs_lifecycle_budget_.measured())                                                        \
+        {                                                                                          \
+            qs_lifecycle_budget_.check();                                                          \
+            if(!qs_lifecycle_budget_.ok())                                                         \
+                on_failure << qs_lifecycle_budget_.report();                                       \
+        }                                                                                          \
+        else                                                                                       \
+            for(qs_lifecycle_budget_.start(); qs_lifecycle_budget_.running();                      \
+                qs_lifecycle_budget_.stop())
+
+// Fail the test when the block goes over the budget, and continue
+#define EXPECT_LIFECYCLE_BUDGET(Tracker, ...)                                                      \
+    QS_LIFECYCLE_BUDGET_(Tracker, ADD_FAILURE(), __VA_ARGS__)
+
+// Fail the test when the block goes over the budget, and return from the test
+#define ASSERT_LIFECYCLE_BUDGET(Tracker, ...) QS_LIFECYCLE_BUDGET_(Tracker, FAIL(), __VA_ARGS__)
+
+
+#endif // QS_LIFECYCLE_GTEST_H
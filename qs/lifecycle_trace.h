@@ -0,0 +1,844 @@
+// MIT License
+
+// Copyright (c) 2025 Jose Sa
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+
+
+#ifndef QS_LIFECYCLE_TRACE_H
+#define QS_LIFECYCLE_TRACE_H
+
+
+// Binary traces of every lifecycle event, and their offline analysis.
+//
+//     qs::lifecycle_trace_writer trace{"run.qstrace"};
+//     run();
+//     trace.close();
+//
+// `lifecycle_analyze run.qstrace` then splits the trace in chunks of records, aggregates them
+// on every core and merges the results: the counters as print_counters() reports them, the
+// lifetimes of the objects, the top copy sites and the alive objects over time.
+//
+// A trace starts with the 8 bytes "QSTRACE1" and continues with fixed-size records in event
+// order. At close the writer appends a text trailer with the types and the copy sites, then a
+// footer with the number of records, the offset of the trailer and the 8 bytes "QSTREND1".
+
+#include <qs/lifecycle_tracker.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+QS_NAMESPACE_BEGIN
+
+// An event of a trace, in the native byte order of the traced program
+struct lifecycle_trace_record
+{
+    uint64_t time_ns; // since the trace was opened
+    uint64_t object;  // address of the tracked object
+    uint32_t type;    // index of the type in the trailer
+    uint32_t site;    // copy site of copy events, 0 when unknown
+    uint32_t event;   // qs::lifecycle_event
+    uint32_t reserved;
+};
+
+static_assert(sizeof(lifecycle_trace_record) == 32, "trace records have a fixed size");
+
+// Options of qs::lifecycle_trace::analyze
+struct lifecycle_trace_options
+{
+    // Worker threads, all the cores when 0
+    unsigned threads = 0;
+    // Records per chunk handed to a worker
+    size_t chunk_records = size_t{1} << 20;
+    // Points of the alive-over-time curve
+    size_t timeline_points = 50;
+    // Copy sites kept per type
+    size_t top_sites = 5;
+};
+
+// A copy site of a trace, with the count of copies of one type made there
+struct lifecycle_trace_site
+{
+    size_t                   count;
+    std::vector<std::string> frames;
+};
+
+// What a trace says about one tracked type
+struct lifecycle_trace_type
+{
+    std::string name;
+    size_t      uuid;
+    bool        mt;
+    // Counters when the trace was opened and when it was closed
+    lifecycle_counters initial;
+    lifecycle_counters closing;
+    // Events in the trace
+    lifecycle_counters events;
+    // Objects by lifetime, lifetimes[k] lived between 2^k and 2^(k+1) - 1 ns
+    std::vector<size_t> lifetimes;
+    // Copy sites, the most frequent first
+    std::vector<lifecycle_trace_site> copy_sites;
+
+    // Counters at the end of the run, as print_counters() reported them
+    lifecycle_counters counters() const noexcept
+    {
+        return {initial.constructor + events.constructor,
+                initial.copy_constructor + events.copy_constructor,
+                initial.move_constructor + events.move_constructor,
+                initial.copy_assignment + events.copy_assignment,
+                initial.move_assignment + events.move_assignment,
+                initial.destructor + events.destructor};
+    }
+};
+
+// Result of qs::lifecycle_trace::analyze
+struct lifecycle_trace_analysis
+{
+    std::vector<lifecycle_trace_type> types;
+    size_t                            records     = 0;
+    uint64_t                          duration_ns = 0;
+    // Alive objects of every type at the end of each period of point_ns nanoseconds
+    uint64_t               point_ns = 0;
+    std::vector<ptrdiff_t> alive;
+};
+
+
+namespace intl
+{
+    // Copy sites of the trace, with the frames of the tracker and the writer dropped
+    inline std::vector<std::string> trace_site_frames(uint32_t stack_id)
+    {
+        std::vector<std::string> frames = lifecycle_stack_table::instance().symbolize(stack_id);
+        auto const               user   = std::find_if(
+            frames.begin(), frames.end(),
+            [](std::string const& frame)
+            {
+                return frame.find("lifecycle_") == std::string::npos &&
+                       frame.find("std::function") == std::string::npos &&
+                       frame.find("std::_Function") == std::string::npos;
+            });
+        frames.erase(frames.begin(), user);
+        return frames;
+    }
+
+    // Trace written by qs::lifecycle_trace_writer, shared with the callback that can still be
+    // running after the subscription is dropped. Each thread buffers its records, and a flush
+    // writes the records of every thread older than the flush in time order.
+    class lifecycle_trace_state
+    {
+    public:
+        explicit lifecycle_trace_state(std::FILE* file, bool copy_sites)
+            : file_{file},
+              copy_sites_{copy_sites},
+              id_{next_id_()},
+              start_{std::chrono::steady_clock::now()}
+        {
+            lifecycle_registry::snapshot(initial_);
+        }
+
+        void on_event(lifecycle_event_info const& info)
+        {
+            bool const copy = info.event == lifecycle_event::CopyConstructor ||
+                              info.event == lifecycle_event::CopyAssignment;
+            uint32_t const site =
+                copy && copy_sites_ ? lifecycle_stack_table::instance().intern(capture_stack(1))
+                                    : 0;
+
+            buffer_t& buffer = buffer_();
+            lifecycle_trace_record record{};
+            record.object = static_cast<uint64_t>(reinterpret_cast<std::uintptr_t>(info.object));
+            record.type   = buffer.type_index(info, *this);
+            record.site   = site;
+            record.event  = static_cast<uint32_t>(info.event);
+            {
+                // stamped under the lock, so that a flush sees every record older than itself
+                std::lock_guard<std::mutex> lock{buffer.mutex};
+                if(closed_.load(std::memory_order_relaxed))
+                    return;
+                record.time_ns = now_ns_();
+                buffer.records.push_back(record);
+                if(site != 0)
+                    buffer.sites.insert(site);
+                if(buffer.records.size() < buffer_records)
+                    return;
+            }
+            std::lock_guard<std::mutex> lock{mutex_};
+            if(file_ != nullptr)
+                flush_(now_ns_());
+        }
+
+        // Write the trailer and the footer, returning false if the trace is incomplete
+        bool close()
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            if(file_ == nullptr)
+                return ok_;
+            closed_.store(true, std::memory_order_relaxed);
+            flush_(UINT64_MAX);
+
+            std::string trailer = "types " + std::to_string(types_.size()) + "\n";
+            for(type_t const& type : types_)
+            {
+                lifecycle_counters closing = type.initial;
+                if(lifecycle_type_entry const* const entry = lifecycle_registry::get(type.id))
+                    closing = entry->counters();
+                trailer += std::to_string(type.uuid) + (type.mt ? " 1" : " 0");
+                append_counters_(trailer, type.initial);
+                append_counters_(trailer, closing);
+                trailer += " " + one_line_(*type.name) + "\n";
+            }
+            trailer += "sites " + std::to_string(sites_.size()) + "\n";
+            for(uint32_t const site : sites_)
+            {
+                std::vector<std::string> const frames = trace_site_frames(site);
+                trailer += std::to_string(site) + " " + std::to_string(frames.size()) + "\n";
+                for(std::string const& frame : frames)
+                    trailer += one_line_(frame) + "\n";
+            }
+
+            uint64_t const footer[2] = {records_, offset_()};
+            write_(trailer.data(), trailer.size());
+            write_(footer, sizeof(footer));
+            write_("QSTREND1", 8);
+            ok_ = std::fclose(file_) == 0 && ok_;
+            file_ = nullptr;
+            return ok_;
+        }
+
+    private:
+        static constexpr size_t buffer_records = 4096;
+
+        struct type_t
+        {
+            std::string const* name;
+            size_t             uuid;
+            bool               mt;
+            size_t             id; // in qs::lifecycle_registry
+            lifecycle_counters initial;
+        };
+
+        // Records of one thread, and the type indices it has already looked up
+        struct buffer_t
+        {
+            std::thread::id                           owner;
+            std::mutex                                mutex;
+            std::vector<lifecycle_trace_record>       records;
+            std::set<uint32_t>                        sites;
+            std::unordered_map<void const*, uint32_t> type_ids; // read by the owner only
+
+            uint32_t type_index(lifecycle_event_info const& info, lifecycle_trace_state& state)
+            {
+                auto const it = type_ids.find(&info.type_name);
+                if(it != type_ids.end())
+                    return it->second;
+                std::lock_guard<std::mutex> lock{state.mutex_};
+                return type_ids[&info.type_name] = state.type_index_(info);
+            }
+        };
+
+        std::mutex                                  mutex_;
+        std::FILE*                                  file_;
+        bool                                        copy_sites_;
+        bool                                        ok_ = true;
+        std::atomic<bool>                           closed_{false};
+        uint64_t                                    id_;
+        std::chrono::steady_clock::time_point       start_;
+        std::vector<lifecycle_counters>             initial_;
+        std::vector<std::unique_ptr<buffer_t>>      buffers_;
+        std::vector<lifecycle_trace_record>         pending_;
+        uint64_t                                    records_ = 0;
+        std::vector<type_t>                         types_;
+        std::unordered_map<void const*, uint32_t>   type_ids_;
+        std::set<uint32_t>                          sites_;
+
+        static uint64_t next_id_() noexcept
+        {
+            static std::atomic<uint64_t> next{0};
+            return ++next;
+        }
+
+        uint64_t now_ns_() const noexcept
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                             std::chrono::steady_clock::now() - start_)
+                                             .count());
+        }
+
+        // Buffer of the calling thread, cached for the last trace it wrote to
+        buffer_t& buffer_()
+        {
+            struct cache_t
+            {
+                uint64_t  trace  = 0;
+                buffer_t* buffer = nullptr;
+            };
+            static thread_local cache_t cache;
+            if(cache.trace == id_)
+                return *cache.buffer;
+
+            std::lock_guard<std::mutex> lock{mutex_};
+            std::thread::id const       self = std::this_thread::get_id();
+            auto const                  it   = std::find_if(buffers_.begin(), buffers_.end(),
+                                                            [self](std::unique_ptr<buffer_t> const& buffer)
+                                                            { return buffer->owner == self; });
+            buffer_t* buffer = it != buffers_.end() ? it->get() : nullptr;
+            if(buffer == nullptr)
+            {
+                buffers_.emplace_back(buffer = new buffer_t{});
+                buffer->owner = self;
+                buffer->records.reserve(buffer_records);
+            }
+            cache = {id_, buffer};
+            return *buffer;
+        }
+
+        // Index of the type in the trailer, keyed by the address of its name
+        uint32_t type_index_(lifecycle_event_info const& info)
+        {
+            auto const it = type_ids_.find(&info.type_name);
+            if(it != type_ids_.end())
+                return it->second;
+
+            type_t type{&info.type_name, info.uuid, info.mt, QS_LIFECYCLE_REGISTRY_CAPACITY, {}};
+            for(size_t id = 0; id < lifecycle_registry::size(); ++id)
+            {
+                lifecycle_type_entry const* const entry = lifecycle_registry::get(id);
+                if(entry != nullptr && &entry->type_name() == &info.type_name &&
+                   entry->mt == info.mt)
+                {
+                    type.id      = id;
+                    type.initial = id < initial_.size() ? initial_[id] : lifecycle_counters{};
+                    break;
+                }
+            }
+            auto const index = static_cast<uint32_t>(types_.size());
+            types_.push_back(type);
+            type_ids_.emplace(&info.type_name, index);
+            return index;
+        }
+
+        // Write the records of every thread stamped before cutoff, in time order. The records of
+        // a thread are in time order, and it stamps later ones after the flush locked it.
+        void flush_(uint64_t cutoff)
+        {
+            for(std::unique_ptr<buffer_t> const& buffer : buffers_)
+            {
+                std::lock_guard<std::mutex> lock{buffer->mutex};
+                auto const last = std::find_if(buffer->records.begin(), buffer->records.end(),
+                                               [cutoff](lifecycle_trace_record const& record)
+                                               { return record.time_ns >= cutoff; });
+                pending_.insert(pending_.end(), buffer->records.begin(), last);
+                buffer->records.erase(buffer->records.begin(), last);
+                sites_.insert(buffer->sites.begin(), buffer->sites.end());
+                buffer->sites.clear();
+            }
+            std::stable_sort(pending_.begin(), pending_.end(),
+                             [](lifecycle_trace_record const& a, lifecycle_trace_record const& b)
+                             { return a.time_ns < b.time_ns; });
+            write_(pending_.data(), pending_.size() * sizeof(lifecycle_trace_record));
+            records_ += pending_.size();
+            pending_.clear();
+        }
+
+        void write_(void const* data, size_t size)
+        {
+            ok_ = std::fwrite(data, 1, size, file_) == size && ok_;
+        }
+
+        uint64_t offset_() const noexcept
+        {
+            return 8 + records_ * sizeof(lifecycle_trace_record);
+        }
+
+        static void append_counters_(std::string& out, lifecycle_counters const& cnts)
+        {
+            for(size_t const value : {cnts.constructor, cnts.copy_constructor,
+                                      cnts.move_constructor, cnts.copy_assignment,
+                                      cnts.move_assignment, cnts.destructor})
+                out += " " + std::to_string(value);
+        }
+
+        static std::string one_line_(std::string str)
+        {
+            std::replace(str.begin(), str.end(), '\n', ' ');
+            return str;
+        }
+    };
+} // namespace intl
+
+
+// Writes every event of every tracked type to a binary trace until closed. The counters of the
+// types are read when it opens and closes, so that the analysis can reproduce print_counters().
+// The events counted in a qs::lifecycle_counter_context are traced but not in those counters.
+class lifecycle_trace_writer
+{
+public:
+    explicit lifecycle_trace_writer(char const* path, bool copy_sites = true)
+    {
+        std::FILE* const file = std::fopen(path, "wb");
+        if(file == nullptr || std::fwrite("QSTRACE1", 1, 8, file) != 8)
+        {
+            if(file != nullptr)
+                std::fclose(file);
+            return;
+        }
+        state_ = std::make_shared<intl::lifecycle_trace_state>(file, copy_sites);
+        std::shared_ptr<intl::lifecycle_trace_state> const state = state_;
+        subscription_ = lifecycle_subscribers::subscribe(
+            [state](lifecycle_event_info const& info) { state->on_event(info); });
+    }
+
+    lifecycle_trace_writer(lifecycle_trace_writer const&)            = delete;
+    lifecycle_trace_writer& operator=(lifecycle_trace_writer const&) = delete;
+
+    ~lifecycle_trace_writer() { close(); }
+
+    // Check if the trace file could be created
+    bool is_open() const noexcept { return state_ != nullptr; }
+
+    // Stop tracing and complete the file, returning false if it could not be written
+    bool close()
+    {
+        subscription_.unsubscribe();
+        return state_ != nullptr && state_->close();
+    }
+
+private:
+    std::shared_ptr<intl::lifecycle_trace_state> state_;
+    lifecycle_subscription                       subscription_;
+};
+
+
+namespace intl
+{
+    // Aggregates of a chunk of records, merged in chunk order
+    struct lifecycle_trace_chunk
+    {
+        struct object_key
+        {
+            uint64_t object;
+            uint32_t type;
+
+            bool operator==(object_key const& rhs) const noexcept
+            {
+                return object == rhs.object && type == rhs.type;
+            }
+        };
+
+        struct object_key_hash
+        {
+            size_t operator()(object_key const& key) const noexcept
+            {
+                return std::hash<uint64_t>{}(key.object ^ (uint64_t{key.type} << 48));
+            }
+        };
+
+        struct type_t
+        {
+            size_t                               events[6] = {};
+            size_t                               lifetimes[64] = {};
+            std::unordered_map<uint32_t, size_t> sites;
+        };
+
+        std::vector<type_t>                                         types;
+        std::vector<ptrdiff_t>                                      alive_deltas;
+        // Constructions not destroyed in the chunk, and destructions of older objects in order
+        std::unordered_map<object_key, uint64_t, object_key_hash> opened;
+        std::vector<std::pair<object_key, uint64_t>>              closed;
+
+        static size_t log2_(uint64_t ns) noexcept
+        {
+            size_t k = 0;
+            while(ns >>= 1)
+                ++k;
+            return k;
+        }
+
+        void add(lifecycle_trace_record const& record, uint64_t point_ns)
+        {
+            type_t& type = types[record.type];
+            ++type.events[record.event];
+            if(record.site != 0)
+                ++type.sites[record.site];
+
+            auto const   event  = static_cast<lifecycle_event>(record.event);
+            size_t const point  = static_cast<size_t>(record.time_ns / point_ns);
+            object_key const key{record.object, record.type};
+            if(event == lifecycle_event::Destructor)
+            {
+                --alive_deltas[(std::min)(point, alive_deltas.size() - 1)];
+                auto const it = opened.find(key);
+                if(it == opened.end())
+                {
+                    closed.emplace_back(key, record.time_ns);
+                    return;
+                }
+                ++types[record.type].lifetimes[log2_(record.time_ns - it->second)];
+                opened.erase(it);
+            }
+            else if(event == lifecycle_event::Constructor ||
+                    event == lifecycle_event::CopyConstructor ||
+                    event == lifecycle_event::MoveConstructor)
+            {
+                ++alive_deltas[(std::min)(point, alive_deltas.size() - 1)];
+                opened[key] = record.time_ns;
+            }
+        }
+    };
+
+    // Totals of the chunks merged so far, in chunk order
+    struct lifecycle_trace_merge
+    {
+        using chunk_t = lifecycle_trace_chunk;
+
+        std::vector<lifecycle_trace_type>                 types;
+        std::vector<std::unordered_map<uint32_t, size_t>> sites;
+        std::vector<ptrdiff_t>                            deltas;
+        // objects alive at the end of the chunks merged so far
+        std::unordered_map<chunk_t::object_key, uint64_t, chunk_t::object_key_hash> opened;
+
+        void add(chunk_t const& chunk)
+        {
+            for(size_t t = 0; t < types.size(); ++t)
+            {
+                lifecycle_trace_type&  type = types[t];
+                chunk_t::type_t const& part = chunk.types[t];
+                type.events.constructor += part.events[0];
+                type.events.copy_constructor += part.events[1];
+                type.events.move_constructor += part.events[2];
+                type.events.copy_assignment += part.events[3];
+                type.events.move_assignment += part.events[4];
+                type.events.destructor += part.events[5];
+                for(size_t k = 0; k < 64; ++k)
+                    type.lifetimes[k] += part.lifetimes[k];
+                for(auto const& site : part.sites)
+                    sites[t][site.first] += site.second;
+            }
+            for(size_t i = 0; i < deltas.size(); ++i)
+                deltas[i] += chunk.alive_deltas[i];
+
+            // objects created in an earlier chunk and destroyed in this one
+            for(auto const& closed : chunk.closed)
+            {
+                auto const it = opened.find(closed.first);
+                if(it == opened.end())
+                    continue; // created before the trace was opened
+                ++types[closed.first.type].lifetimes[chunk_t::log2_(closed.second - it->second)];
+                opened.erase(it);
+            }
+            for(auto const& open : chunk.opened)
+                opened[open.first] = open.second;
+        }
+    };
+
+    // Footer and trailer of a trace
+    struct lifecycle_trace_index
+    {
+        uint64_t                                             records = 0;
+        std::vector<lifecycle_trace_type>                    types;
+        std::unordered_map<uint32_t, std::vector<std::string>> sites;
+
+        bool read(std::ifstream& in)
+        {
+            char     magic[8];
+            uint64_t footer[2];
+            in.seekg(0, std::ios::end);
+            auto const size = static_cast<uint64_t>(in.tellg());
+            if(size < 8 + sizeof(footer) + 8)
+                return false;
+            in.seekg(0);
+            if(!in.read(magic, 8) || std::string(magic, 8) != "QSTRACE1")
+                return false;
+            in.seekg(static_cast<std::streamoff>(size - sizeof(footer) - 8));
+            if(!in.read(reinterpret_cast<char*>(footer), sizeof(footer)) || !in.read(magic, 8) ||
+               std::string(magic, 8) != "QSTREND1")
+                return false;
+            records = footer[0];
+            if(footer[1] != 8 + records * sizeof(lifecycle_trace_record) ||
+               footer[1] > size - sizeof(footer) - 8)
+                return false;
+
+            std::string trailer(static_cast<size_t>(size - sizeof(footer) - 8 - footer[1]), '\0');
+            in.seekg(static_cast<std::streamoff>(footer[1]));
+            if(!in.read(&trailer[0], static_cast<std::streamsize>(trailer.size())))
+                return false;
+            return parse_(trailer);
+        }
+
+    private:
+        bool parse_(std::string const& trailer)
+        {
+            std::istringstream lines{trailer};
+            std::string        word;
+            size_t             count = 0;
+            if(!(lines >> word >> count) || word != "types")
+                return false;
+            for(size_t i = 0; i < count; ++i)
+            {
+                lifecycle_trace_type type{};
+                if(!(lines >> type.uuid >> type.mt) || !read_counters_(lines, type.initial) ||
+                   !read_counters_(lines, type.closing) || lines.get() != ' ' ||
+                   !std::getline(lines, type.name))
+                    return false;
+                type.lifetimes.assign(64, 0);
+                types.push_back(std::move(type));
+            }
+            if(!(lines >> word >> count) || word != "sites")
+                return false;
+            for(size_t i = 0; i < count; ++i)
+            {
+                uint32_t id     = 0;
+                size_t   frames = 0;
+                if(!(lines >> id >> frames) || lines.get() != '\n')
+                    return false;
+                std::vector<std::string>& site = sites[id];
+                site.resize(frames);
+                for(std::string& frame : site)
+                    if(!std::getline(lines, frame))
+                        return false;
+            }
+            return true;
+        }
+
+        static bool read_counters_(std::istream& in, lifecycle_counters& cnts)
+        {
+            return static_cast<bool>(in >> cnts.constructor >> cnts.copy_constructor >>
+                                     cnts.move_constructor >> cnts.copy_assignment >>
+                                     cnts.move_assignment >> cnts.destructor);
+        }
+    };
+} // namespace intl
+
+
+// Offline analysis of the traces of qs::lifecycle_trace_writer
+class lifecycle_trace
+{
+public:
+    // Analyze a trace in parallel, streaming each chunk from the file, so that traces larger
+    // than the memory can be read. Each chunk is merged and freed as soon as the chunks before
+    // it are, and at most two per worker are held at once. Returns false if the file is not a
+    // complete trace.
+    static bool analyze(char const* path, lifecycle_trace_analysis& out,
+                        lifecycle_trace_options const& options = {})
+    {
+        using chunk_t = intl::lifecycle_trace_chunk;
+
+        std::ifstream in{path, std::ios::binary};
+        intl::lifecycle_trace_index index;
+        if(!in || !index.read(in))
+            return false;
+
+        out         = lifecycle_trace_analysis{};
+        out.records = static_cast<size_t>(index.records);
+        if(index.records != 0)
+        {
+            lifecycle_trace_record last{};
+            in.seekg(static_cast<std::streamoff>(8 + (index.records - 1) * sizeof(last)));
+            if(!in.read(reinterpret_cast<char*>(&last), sizeof(last)))
+                return false;
+            out.duration_ns = last.time_ns;
+        }
+        size_t const points = (std::max)(options.timeline_points, size_t{1});
+        out.point_ns        = out.duration_ns / points + 1;
+
+        intl::lifecycle_trace_merge merge;
+        merge.types = std::move(index.types);
+        merge.sites.resize(merge.types.size());
+        merge.deltas.assign(points, 0);
+
+        // chunks are handed out to the workers in order, and merged in the same order by the
+        // worker that completes the next one to merge
+        size_t const chunk_records = (std::max)(options.chunk_records, size_t{1});
+        size_t const chunks = static_cast<size_t>((index.records + chunk_records - 1) / chunk_records);
+        unsigned const threads = static_cast<unsigned>((std::min)(
+            size_t{options.threads != 0 ? options.threads
+                                        : (std::max)(std::thread::hardware_concurrency(), 1u)},
+            (std::max)(chunks, size_t{1})));
+        size_t const window = 2 * size_t{threads};
+
+        std::mutex                mutex;
+        std::condition_variable   cv;
+        std::map<size_t, chunk_t> ready;
+        size_t                    next    = 0;
+        size_t                    merged  = 0;
+        bool                      merging = false;
+        bool                      ok      = true;
+        auto const                fail    = [&]
+        {
+            {
+                std::lock_guard<std::mutex> lock{mutex};
+                ok = false;
+            }
+            cv.notify_all();
+        };
+        auto const worker = [&]
+        {
+            std::ifstream                       file{path, std::ios::binary};
+            std::vector<lifecycle_trace_record> block(4096);
+            for(;;)
+            {
+                size_t chunk = 0;
+                {
+                    std::unique_lock<std::mutex> lock{mutex};
+                    cv.wait(lock, [&] { return !ok || next >= chunks || next < merged + window; });
+                    if(!ok || next >= chunks)
+                        return;
+                    chunk = next++;
+                }
+
+                chunk_t res;
+                res.types.resize(merge.types.size());
+                res.alive_deltas.assign(points, 0);
+
+                size_t const first = chunk * chunk_records;
+                size_t const last  = (std::min)(first + chunk_records, out.records);
+                file.seekg(static_cast<std::streamoff>(8 + first * sizeof(lifecycle_trace_record)));
+                for(size_t pos = first; pos < last;)
+                {
+                    size_t const n = (std::min)(block.size(), last - pos);
+                    if(!file.read(reinterpret_cast<char*>(block.data()),
+                                  static_cast<std::streamsize>(n * sizeof(lifecycle_trace_record))))
+                        return fail();
+                    for(size_t i = 0; i < n; ++i)
+                    {
+                        if(block[i].type >= res.types.size() || block[i].event >= 6)
+                            return fail();
+                        res.add(block[i], out.point_ns);
+                    }
+                    pos += n;
+                }
+
+                std::unique_lock<std::mutex> lock{mutex};
+                ready.emplace(chunk, std::move(res));
+                if(merging)
+                    continue;
+                merging = true;
+                while(ok && !ready.empty() && ready.begin()->first == merged)
+                {
+                    chunk_t done = std::move(ready.begin()->second);
+                    ready.erase(ready.begin());
+                    lock.unlock();
+                    merge.add(done);
+                    done = chunk_t{};
+                    lock.lock();
+                    ++merged;
+                    cv.notify_all();
+                }
+                merging = false;
+            }
+        };
+
+        std::vector<std::thread> pool;
+        for(unsigned i = 1; i < threads; ++i)
+            pool.emplace_back(worker);
+        worker();
+        for(std::thread& thread : pool)
+            thread.join();
+        if(!ok)
+            return false;
+
+        finish_(index, merge, options, out);
+        return true;
+    }
+
+    // Report of an analysis, starting with the counters in the format of print_counters()
+    static std::string format(lifecycle_trace_analysis const& analysis)
+    {
+        std::string out;
+        for(lifecycle_trace_type const& type : analysis.types)
+        {
+            intl::format_counters(out, type.counters(), type.name, type.uuid);
+            std::string const tag =
+                "[type: " + type.name + ", uuid: " + std::to_string(type.uuid) + "]";
+            if(!(type.counters() == type.closing))
+                out += "Lifecycle trace " + tag +
+                       ": the counters differ from the ones read at close, events were counted "
+                       "in a counter context or the counters were reset\n";
+
+            out += "Lifecycle lifetimes " + tag + ":\n";
+            for(size_t k = 0; k < type.lifetimes.size(); ++k)
+                if(type.lifetimes[k] != 0)
+                    out += " * < " + std::to_string(uint64_t{2} << k) +
+                           " ns : " + std::to_string(type.lifetimes[k]) + "\n";
+
+            for(lifecycle_trace_site const& site : type.copy_sites)
+            {
+                out += "Lifecycle copy site " + tag + ": " + std::to_string(site.count) +
+                       " copies\n";
+                for(std::string const& frame : site.frames)
+                    out += "    " + frame + "\n";
+            }
+        }
+        out += "Lifecycle alive over time [" + std::to_string(analysis.records) + " events, " +
+               std::to_string(analysis.duration_ns) + " ns]:\n";
+        for(size_t i = 0; i < analysis.alive.size(); ++i)
+            out += " * " + std::to_string((i + 1) * analysis.point_ns) +
+                   " ns : " + std::to_string(analysis.alive[i]) + "\n";
+        return out;
+    }
+
+private:
+    static void finish_(intl::lifecycle_trace_index& index, intl::lifecycle_trace_merge& merge,
+                        lifecycle_trace_options const& options, lifecycle_trace_analysis& out)
+    {
+        out.types = std::move(merge.types);
+
+        ptrdiff_t alive = 0;
+        for(lifecycle_trace_type const& type : out.types)
+            alive += type.initial.alive();
+        for(ptrdiff_t const delta : merge.deltas)
+            out.alive.push_back(alive += delta);
+
+        for(size_t t = 0; t < out.types.size(); ++t)
+        {
+            std::vector<std::pair<uint32_t, size_t>> ranked(merge.sites[t].begin(),
+                                                            merge.sites[t].end());
+            std::sort(ranked.begin(), ranked.end(),
+                      [](std::pair<uint32_t, size_t> const& a, std::pair<uint32_t, size_t> const& b)
+                      { return a.second != b.second ? a.second > b.second : a.first < b.first; });
+            if(ranked.size() > options.top_sites)
+                ranked.resize(options.top_sites);
+            for(auto const& site : ranked)
+                out.types[t].copy_sites.push_back({site.second, index.sites[site.first]});
+        }
+    }
+};
+
+QS_NAMESPACE_END
+
+
+#endif // QS_LIFECYCLE_TRACE_H
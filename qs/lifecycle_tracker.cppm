@@ -0,0 +1,98 @@
+// MIT License
+
+// Copyright (c) 2025 Jose Sa
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+// C++20 module of the trackers. Configuration macros (QS_LIFECYCLE_*) must be set when the module
+// is built, they are not visible to importers.
+//
+//     import qs.lifecycle_tracker;
+//     qs::lifecycle_tracker<Widget> w;
+
+module;
+
+#ifndef QS_LIFECYCLE_TRACKER_COMPILED
+#define QS_LIFECYCLE_TRACKER_COMPILED 1
+#endif
+#include <qs/lifecycle_tracker.h>
+
+export module qs.lifecycle_tracker;
+
+export namespace qs
+{
+    using qs::demangler;
+
+    using qs::lifecycle_all_events;
+    using qs::lifecycle_counters;
+    using qs::lifecycle_event;
+    using qs::lifecycle_event_bit;
+    using qs::lifecycle_event_mask;
+
+    using qs::lifecycle_default_logger;
+    using qs::lifecycle_logger;
+    using qs::lifecycle_log_filter;
+    using qs::lifecycle_tracker;
+    using qs::lifecycle_tracker_mt;
+    using qs::tracked;
+    using qs::tracked_mt;
+
+    using qs::lifecycle_file_sink;
+    using qs::lifecycle_ring_sink;
+    using qs::lifecycle_sink;
+    using qs::lifecycle_sinks;
+    using qs::lifecycle_syslog_sink;
+
+    using qs::lifecycle_callback;
+    using qs::lifecycle_event_info;
+    using qs::lifecycle_function;
+    using qs::lifecycle_subscribers;
+    using qs::lifecycle_subscription;
+
+    using qs::lifecycle_constexpr_context;
+    using qs::lifecycle_counter_context;
+    using qs::lifecycle_counter_scope;
+    using qs::lifecycle_leak_stack;
+    using qs::lifecycle_leaks;
+    using qs::lifecycle_missed_move;
+    using qs::lifecycle_move_quality;
+    using qs::lifecycle_overhead;
+    using qs::lifecycle_overheads;
+    using qs::lifecycle_perf_counters;
+    using qs::lifecycle_carry_task;
+    using qs::lifecycle_registry;
+#if QS_LIFECYCLE_TRACKER_WITH_SIGNAL_DUMP
+    using qs::lifecycle_signal_dump;
+#endif
+    using qs::lifecycle_task_awaiter;
+    using qs::lifecycle_task_context;
+    using qs::lifecycle_task_counters;
+    using qs::lifecycle_task_scope;
+    using qs::lifecycle_thread_counters;
+    using qs::lifecycle_thread_pair;
+    using qs::lifecycle_threads;
+    using qs::lifecycle_type_entry;
+    using qs::lifecycle_type_overhead;
+    using qs::lifecycle_watchdog_alert;
+    using qs::lifecycle_watchdog_callback;
+    using qs::lifecycle_watchdog_limit;
+    using qs::lifecycle_watchdog_limits;
+} // namespace qs
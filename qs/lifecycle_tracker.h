@@ -34,6 +34,9 @@
 #include <string>
 #include <tuple>
 #include <type_traits>
+#include <utility>
+
+#include <qs/lifecycle_tracker_fwd.h>
 
 #if defined(__cpp_lib_string_view)
 #include <string_view>
@@ -318,6 +321,19 @@
 #else
 #define QS_ALWAYS_INLINE inline
 #endif
+#if QS_GCC_VERSION || QS_CLANG_VERSION
+#define QS_NOINLINE __attribute__((noinline))
+#elif QS_MSVC_VERSION
+#define QS_NOINLINE __declspec(noinline)
+#else
+#define QS_NOINLINE
+#endif
+// Rarely executed functions, optimized for size and placed away from the hot code
+#if QS_GCC_VERSION || QS_CLANG_VERSION
+#define QS_COLD __attribute__((cold))
+#else
+#define QS_COLD
+#endif
 // A version of QS_INLINE to prevent code bloat in debug mode.
 #ifdef NDEBUG
 #define QS_INLINE QS_ALWAYS_INLINE
@@ -331,6 +347,14 @@
 #define QS_VISIBILITY(value)
 #endif
 
+#if QS_HAS_BUILTIN(__builtin_expect) || QS_GCC_VERSION
+#define QS_LIKELY(x) __builtin_expect(!!(x), 1)
+#define QS_UNLIKELY(x) __builtin_expect(!!(x), 0)
+#else
+#define QS_LIKELY(x) (x)
+#define QS_UNLIKELY(x) (x)
+#endif
+
 #ifdef QS_INLINE_VAR
 // Use the provided definition
 #elif defined(__cpp_inline_variables)
@@ -341,6 +365,54 @@
 #define QS_INLINE_VAR_INIT(...)
 #endif
 
+// With QS_LIFECYCLE_TRACKER_COMPILED, the formatting of the default logger and the demangling
+// are compiled once in src/lifecycle_tracker.cpp (the lifecycle_tracker_compiled target), so
+// tracked types do not include fmt, <format> or <cxxabi.h>. QS_LIFECYCLE_TRACKER_COMPILED_IMPL is
+// only defined by that source file.
+#ifndef QS_LIFECYCLE_TRACKER_COMPILED
+#define QS_LIFECYCLE_TRACKER_COMPILED 0
+#endif
+#if QS_LIFECYCLE_TRACKER_COMPILED && !defined(QS_LIFECYCLE_TRACKER_COMPILED_IMPL)
+#define QS_LIFECYCLE_DECLARE_ONLY 1
+#else
+#define QS_LIFECYCLE_DECLARE_ONLY 0
+#endif
+#if QS_LIFECYCLE_TRACKER_COMPILED
+#define QS_LIFECYCLE_API
+#else
+#define QS_LIFECYCLE_API inline
+#endif
+
+// Check for fmt library support
+#ifdef QS_LIFECYCLE_TRACKER_WITH_FMTLIB
+// user provided option
+#elif QS_HAS_INCLUDE("fmt/core.h")
+#define QS_LIFECYCLE_TRACKER_WITH_FMTLIB 1
+#else
+#define QS_LIFECYCLE_TRACKER_WITH_FMTLIB 0
+#endif
+
+// Formatting library of the default logger: 1 for fmt, 2 for <format> and 0 for printf. Every
+// translation unit of a program, and the lifecycle_tracker_compiled library, must use the same
+// value and the same QS_LIFECYCLE_TRACKER_COMPILED. Set it explicitly when the detection can
+// differ between them, e.g. when only some of them see fmt or are built as C++23.
+#ifndef QS_LIFECYCLE_TRACKER_FORMAT
+#if QS_LIFECYCLE_TRACKER_WITH_FMTLIB
+#define QS_LIFECYCLE_TRACKER_FORMAT 1
+#elif defined(__cpp_lib_print)
+#define QS_LIFECYCLE_TRACKER_FORMAT 2
+#else
+#define QS_LIFECYCLE_TRACKER_FORMAT 0
+#endif
+#endif
+
+// Inline namespace of the entities that depend on those two macros, so that translation units
+// that disagree refer to distinct entities, and fail to link against the compiled library.
+#define QS_LIFECYCLE_ABI_CAT_(compiled, format) abi_##compiled##_##format
+#define QS_LIFECYCLE_ABI_CAT(compiled, format) QS_LIFECYCLE_ABI_CAT_(compiled, format)
+#define QS_LIFECYCLE_ABI                                                                           \
+    QS_LIFECYCLE_ABI_CAT(QS_LIFECYCLE_TRACKER_COMPILED, QS_LIFECYCLE_TRACKER_FORMAT)
+
 
 #ifdef QS_CACHELINE_SIZE
 // Use the provided definition
@@ -368,6 +440,16 @@ namespace intl
     template<class... Args>
     QS_CONSTEXPR14 void ignore_unused(Args&&...)
     {}
+
+    // True during constant evaluation, always false before C++20
+    constexpr bool is_constant_evaluated() noexcept
+    {
+#if QS_USE_CONSTEVAL
+        return std::is_constant_evaluated();
+#else
+        return false;
+#endif
+    }
 } // namespace intl
 
 QS_NAMESPACE_END
@@ -378,7 +460,10 @@ QS_NAMESPACE_END
 // -----------------------------------------------------------------------------
 
 // demangler includes
-#if (QS_GCC_VERSION || QS_CLANG_VERSION)
+#if QS_LIFECYCLE_DECLARE_ONLY
+// demangled out of line
+#elif (QS_GCC_VERSION || QS_CLANG_VERSION)
+#include <cstdlib>
 #include <cxxabi.h>
 #include <memory>
 #elif QS_MSVC_VERSION
@@ -387,333 +472,5455 @@ QS_NAMESPACE_END
 #pragma comment(lib, "Dbghelp.lib")
 #else
 #endif
+#include <typeinfo>
 
 QS_NAMESPACE_BEGIN
 
+namespace intl
+{
+    inline namespace QS_LIFECYCLE_ABI
+    {
+        // Demangle a name returned by std::type_info::name()
+        QS_LIFECYCLE_API std::string demangle(char const* name)
+#if QS_LIFECYCLE_DECLARE_ONLY
+            ;
+#else
+        {
+#if QS_GCC_VERSION || QS_CLANG_VERSION
+            int status = 0;
+            // __cxa_demangle allocates with malloc and reports the buffer size, not the length
+            std::unique_ptr<char, void (*)(void*)> demangled{
+                abi::__cxa_demangle(name, nullptr, nullptr, &status), std::free};
+            if(status == 0)
+                return demangled.get();
+#endif
+            return name;
+        }
+#endif
+    } // namespace QS_LIFECYCLE_ABI
+} // namespace intl
+
 template<typename T>
 class demangler
 {
 public:
     static QS_CONSTEXPR14 std::string const& get()
     {
-        if(type_name_.empty())
+        if(type_name_().empty())
             set_default_();
-        return type_name_;
+        return type_name_();
     }
 
 #if defined(__cpp_lib_string_view)
-    static QS_CONSTEXPR17 void set(std::string_view const type_name) { type_name_ = type_name; }
+    static QS_CONSTEXPR17 void set(std::string_view const type_name)
+    {
+        type_name_() = type_name;
+    }
 #else
     template<size_t N>
     static QS_CONSTEXPR17 void set(char const (&type_name)[N])
     {
-        type_name_.assign(type_name, N - 1);
+        type_name_().assign(type_name, N - 1);
+    }
+    static QS_CONSTEXPR17 void set(std::string const& type_name)
+    {
+        type_name_() = type_name;
     }
-    static QS_CONSTEXPR17 void set(std::string const& type_name) { type_name_ = type_name; }
 #endif
 
 private:
-    QS_INLINE_VAR static std::string type_name_ QS_INLINE_VAR_INIT({});
+    // Allocated on first use and never destroyed, so that trackers constructed during static
+    // initialization or destroyed during exit can still use it
+    static std::string& type_name_()
+    {
+        static auto* const name = new std::string{};
+        return *name;
+    }
 
     static QS_CONSTEXPR17 void set_default_()
     {
-#if QS_GCC_VERSION || QS_CLANG_VERSION
-        int                   status = 0;
-        size_t                len    = 0;
-        std::unique_ptr<char> demangled;
-        demangled.reset(abi::__cxa_demangle(typeid(T).name(), nullptr, &len, &status));
-        if(status == 0)
-            type_name_.assign(demangled.get(), len - 1);
-        else
-            type_name_ = typeid(T).name();
-
-#else
-        type_name_ = typeid(T).name();
-#endif
+        type_name_() = intl::demangle(typeid(T).name());
     }
 };
 
-#if !defined(__cpp_inline_variables)
-template<typename T>
-std::string demangler<T>::type_name_{};
-#endif
 
 
 QS_NAMESPACE_END
 
 
 // -----------------------------------------------------------------------------
-// lifecycle_tracker
+// lifecycle_sink
 // -----------------------------------------------------------------------------
 
+// sink includes
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+#if QS_LIFECYCLE_DECLARE_ONLY
+// sinks, registry and the tables of the optional features are defined out of line
+#else
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#endif
 
-// Check for fmt library support
-#ifdef QS_LIFECYCLE_TRACKER_WITH_FMTLIB
+// Forward qs::lifecycle_syslog_sink to syslog(3) instead of stderr
+#ifdef QS_LIFECYCLE_TRACKER_WITH_SYSLOG
 // user provided option
-#elif QS_HAS_INCLUDE("fmt/core.h")
-#define QS_LIFECYCLE_TRACKER_WITH_FMTLIB 1
 #else
-#define QS_LIFECYCLE_TRACKER_WITH_FMTLIB 0
+#define QS_LIFECYCLE_TRACKER_WITH_SYSLOG 0
+#endif
+#if QS_LIFECYCLE_TRACKER_WITH_SYSLOG
+#include <syslog.h>
 #endif
 
-// Define logging macros based on available libraries
-#if QS_LIFECYCLE_TRACKER_WITH_FMTLIB
-#include <fmt/core.h>
-#include <fmt/format.h>
-#define QS_LIFECYCLE_LOGGER_PRINT(...) fmt::print(__VA_ARGS__)
-#define QS_LIFECYCLE_LOGGER_STRING_ARG(x) x
-#elif defined(__cpp_lib_print)
-#include <format>
-#include <print>
-#define QS_LIFECYCLE_LOGGER_PRINT(...) std::print(__VA_ARGS__)
-#define QS_LIFECYCLE_LOGGER_STRING_ARG(x) x
-#else
-#define QS_LIFECYCLE_LOGGER_PRINT(...) std::printf(__VA_ARGS__)
-#define QS_LIFECYCLE_LOGGER_STRING_ARG(x) static_cast<int>(x.size()), x.data()
+// Bytes accumulated in the per-thread log buffer before they are written to the sink. Every
+// line is written as it is logged by default, so that it interleaves with the other output of
+// the program. A batch size, e.g. 4096, trades that for fewer writes.
+#ifndef QS_LIFECYCLE_SINK_BATCH_SIZE
+#define QS_LIFECYCLE_SINK_BATCH_SIZE 0
 #endif
 
+// Environment variable configuring the sinks on first use (see qs::lifecycle_sinks::configure)
+#ifndef QS_LIFECYCLE_SINK_ENV
+#define QS_LIFECYCLE_SINK_ENV "QS_LIFECYCLE_SINK"
+#endif
 
 QS_NAMESPACE_BEGIN
 
-// Enum to represent different lifecycle events
-enum class lifecycle_event
+// Destination of the text written by qs::lifecycle_default_logger.
+// Every write holds complete lines, and writes may come from several threads concurrently.
+class lifecycle_sink
 {
-    Constructor     = 0,
-    CopyConstructor = 1,
-    MoveConstructor = 2,
-    CopyAssignment  = 3,
-    MoveAssignment  = 4,
-    Destructor      = 5
+public:
+    virtual ~lifecycle_sink() = default;
+
+    // Write a batch of complete lines
+    virtual void write(char const* data, size_t size) = 0;
+
+    // Flush the underlying device
+    virtual void flush() {}
 };
 
-// Struct to hold lifecycle counters
-struct lifecycle_counters
+// Sink writing to a C stream, either borrowed (stdout, stderr) or an owned, fully buffered file
+class lifecycle_file_sink : public lifecycle_sink
 {
-    size_t constructor;
-    size_t copy_constructor;
-    size_t move_constructor;
-    size_t copy_assignment;
-    size_t move_assignment;
-    size_t destructor;
+public:
+    explicit lifecycle_file_sink(std::FILE* file) noexcept
+        : file_{file}
+    {}
 
-    // Methods to calculate total constructed, assigned, and alive objects
-    constexpr size_t total_constructed() const noexcept
+    explicit lifecycle_file_sink(char const* path, size_t buffer_size = 1 << 16)
+        : file_{std::fopen(path, "w")},
+          owned_{true}
     {
-        return constructor + copy_constructor + move_constructor;
+        if(file_ != nullptr)
+            std::setvbuf(file_, nullptr, _IOFBF, buffer_size);
     }
-    constexpr size_t total_assigned() const noexcept { return copy_assignment + move_assignment; }
-    constexpr ptrdiff_t alive() const noexcept
+
+    lifecycle_file_sink(lifecycle_file_sink const&)            = delete;
+    lifecycle_file_sink& operator=(lifecycle_file_sink const&) = delete;
+
+    ~lifecycle_file_sink() override
     {
-        return static_cast<ptrdiff_t>(total_constructed()) - static_cast<ptrdiff_t>(destructor);
+        if(owned_ && file_ != nullptr)
+            std::fclose(file_);
     }
 
-    // Equality operator for lifecycle_counters
-    constexpr bool operator==(lifecycle_counters const& rhs) const noexcept
+    bool is_open() const noexcept { return file_ != nullptr; }
+
+    void write(char const* data, size_t size) override
     {
-        return constructor == rhs.constructor && copy_constructor == rhs.copy_constructor &&
-               move_constructor == rhs.move_constructor && copy_assignment == rhs.copy_assignment &&
-               move_assignment == rhs.move_assignment && destructor == rhs.destructor;
+        if(file_ != nullptr)
+            std::fwrite(data, 1, size, file_);
     }
+
+    void flush() override
+    {
+        if(file_ != nullptr)
+            std::fflush(file_);
+    }
+
+private:
+    std::FILE* file_;
+    bool       owned_ = false;
 };
 
+// In-memory sink keeping only the most recent bytes
+class lifecycle_ring_sink : public lifecycle_sink
+{
+public:
+    explicit lifecycle_ring_sink(size_t capacity = 1 << 16);
+    ~lifecycle_ring_sink() override;
 
-// clang-format off
-//
-// The qs::lifecycle_logger struct is a template that provides logging functionality for lifecycle events
-// of a given type T and a unique identifier Uuid to distinguish between different lifecycle_trackers.
-// The default logger is qs::lifecycle_default_logger which should not be modified.
-// The user can provide a custom logger by template specialization of qs::lifecycle_logger.
-// NOTE: The logger is not thread-safe for both qs::lifecycle_tracker and qs::lifecycle_tracker_mt.
-//
-//
-// template<class T, size_t Uuid = 0>
-// struct lifecycle_logger
-// {
-//     using value_type      = T; // The type being tracked
-//     using reference       = value_type&; // Reference to the type
-//     using const_reference = value_type const&; // Const reference to the type
-//     using pointer         = value_type*; // Pointer to the type
-//     using const_pointer   = value_type const*; // Const pointer to the type
+    void write(char const* data, size_t size) override;
 
-//     // Logs a specific lifecycle event for the given type instance
-//     template<lifecycle_event Cnt>
-//     QS_CONSTEXPR17 void log_event(const_reference self, std::string const& type_name) const;
+    // Retained text, oldest first
+    std::string contents() const;
 
-//     // Prints the current lifecycle counters for the given type
-//     QS_CONSTEXPR17 void print_counters(lifecycle_counters const& cnts,
-//                                        std::string const&        type_name) const;
-// };
-//
-// clang-format on
+    void clear();
 
+private:
+    struct state_t;
+    std::unique_ptr<state_t> state_;
+};
 
-// Default logger for lifecycle events
-template<class T, size_t Uuid = 0>
-struct lifecycle_default_logger
+#if !QS_LIFECYCLE_DECLARE_ONLY
+struct lifecycle_ring_sink::state_t
 {
-    using value_type      = T;
-    using reference       = value_type&;
-    using const_reference = value_type const&;
-    using pointer         = value_type*;
-    using const_pointer   = value_type const*;
+    std::mutex        mutex;
+    std::vector<char> ring;
+    size_t            head = 0;
+    size_t            size = 0;
+};
 
-    // Log lifecycle event
-    template<lifecycle_event Cnt>
-    QS_CONSTEXPR17 void log_event(const_reference self, std::string const& type_name) const
-    {
-        intl::ignore_unused(self);
-        QS_LIFECYCLE_LOGGER_PRINT(log_event_format<Cnt>(),
-                                  QS_LIFECYCLE_LOGGER_STRING_ARG(type_name),
-                                  QS_LIFECYCLE_LOGGER_STRING_ARG(type_name));
-    }
+QS_LIFECYCLE_API lifecycle_ring_sink::lifecycle_ring_sink(size_t capacity)
+    : state_{new state_t{}}
+{
+    state_->ring.resize(capacity);
+}
+
+QS_LIFECYCLE_API lifecycle_ring_sink::~lifecycle_ring_sink() = default;
 
-    // Print lifecycle counters
-    QS_CONSTEXPR17 void print_counters(lifecycle_counters const& cnts,
-                                       std::string const&        type_name) const
+QS_LIFECYCLE_API void lifecycle_ring_sink::write(char const* data, size_t size)
+{
+    state_t&                    st = *state_;
+    std::lock_guard<std::mutex> lock{st.mutex};
+    size_t const                cap = st.ring.size();
+    if(cap == 0)
+        return;
+    if(size > cap)
     {
-        QS_LIFECYCLE_LOGGER_PRINT(log_counters_format(), QS_LIFECYCLE_LOGGER_STRING_ARG(type_name),
-                                  Uuid, cnts.total_constructed(), cnts.constructor,
-                                  cnts.copy_constructor, cnts.move_constructor,
-                                  cnts.total_assigned(), cnts.copy_assignment, cnts.move_assignment,
-                                  cnts.destructor, cnts.alive());
+        data += size - cap;
+        size = cap;
     }
+    size_t const first = (std::min)(size, cap - st.head);
+    std::memcpy(st.ring.data() + st.head, data, first);
+    std::memcpy(st.ring.data(), data + first, size - first);
+    st.head = (st.head + size) % cap;
+    st.size = (std::min)(st.size + size, cap);
+}
+
+QS_LIFECYCLE_API std::string lifecycle_ring_sink::contents() const
+{
+    state_t&                    st = *state_;
+    std::lock_guard<std::mutex> lock{st.mutex};
+    std::string                 res;
+    if(st.size == 0)
+        return res;
+    size_t const start = (st.head + st.ring.size() - st.size) % st.ring.size();
+    size_t const first = (std::min)(st.size, st.ring.size() - start);
+    res.reserve(st.size);
+    res.append(st.ring.data() + start, first);
+    res.append(st.ring.data(), st.size - first);
+    return res;
+}
+
+QS_LIFECYCLE_API void lifecycle_ring_sink::clear()
+{
+    std::lock_guard<std::mutex> lock{state_->mutex};
+    state_->head = state_->size = 0;
+}
+#endif
 
-protected:
-    // Get format string for logging events
-    template<lifecycle_event Cnt>
-    QS_INLINE static QS_CONSTEXPR14 char const* log_event_format()
+// Sink emitting one syslog-style record per line: "<priority>ident: line".
+// With QS_LIFECYCLE_TRACKER_WITH_SYSLOG the records go to syslog(3), otherwise to stderr.
+class lifecycle_syslog_sink : public lifecycle_sink
+{
+public:
+    explicit lifecycle_syslog_sink(std::string ident    = "lifecycle_tracker",
+                                   int         priority = 7 /*debug*/)
+        : ident_{std::move(ident)},
+          priority_{priority}
+    {}
+
+    void write(char const* data, size_t size) override
     {
-        return event_fmt_map_[static_cast<size_t>(Cnt)];
+        char const* const end = data + size;
+        while(data < end)
+        {
+            auto const* eol = static_cast<char const*>(std::memchr(data, '\n', end - data));
+            if(eol == nullptr)
+                eol = end;
+            emit_(data, static_cast<int>(eol - data));
+            data = eol + 1;
+        }
     }
 
-    // Get format string for logging counters
-    QS_INLINE static QS_CONSTEXPR14 char const* log_counters_format() { return counter_fmt_; }
-
 private:
-    // Format strings for different logging libraries
-#if QS_LIFECYCLE_TRACKER_WITH_FMTLIB || defined(__cpp_lib_print)
-    QS_INLINE_VAR static constexpr std::array<char const*, 6> event_fmt_map_{
-        "{}(...)", "{}({} const&)", "{}({}&&)", "=({} const&)", "=({}&&)", "~{}()"};
-    QS_INLINE_VAR static constexpr char const* counter_fmt_ =
-        "Lifecycle tracker [type: {}, uuid: {}]\n"
-        " * constructor (ctor/copy/move) : {:>5} ({}/{}/{})\n"
-        " * assign (copy/move)           : {:>5} ({}/{})\n"
-        " * destructor (alive)           : {:>5} ({})\n";
-#else
-    QS_INLINE_VAR static constexpr std::array<char const*, 6> event_fmt_map_{
-        "%.*s(...)", "%.*s(%.*s const&)", "%.*s(%.*s&&)", "=(%.*s const&)", "=(%.*s&&)", "~%.*s()"};
-    QS_INLINE_VAR static constexpr char const* counter_fmt_ =
-        "Lifecycle tracker [type: %.*s, uuid: %zu]\n"
-        " * constructor (ctor/copy/move) : %5zu (%zu/%zu/%zu)\n"
-        " * assign (copy/move)           : %5zu (%zu/%zu)\n"
-        " * destructor (alive)           : %5zu (%td)\n";
-#endif
-};
+    std::string ident_;
+    int         priority_;
 
-#if !defined(__cpp_inline_variables)
-template<class T, size_t Uuid>
-constexpr std::array<char const*, 6> lifecycle_default_logger<T, Uuid>::event_fmt_map_;
-template<class T, size_t Uuid>
-constexpr char const* lifecycle_default_logger<T, Uuid>::counter_fmt_;
+    void emit_(char const* line, int size) const
+    {
+#if QS_LIFECYCLE_TRACKER_WITH_SYSLOG
+        ::syslog(priority_, "%s: %.*s", ident_.c_str(), size, line);
+#else
+        std::fprintf(stderr, "<%d>%s: %.*s\n", priority_, ident_.c_str(), size, line);
 #endif
+    }
+};
 
 
-// Logger for lifecycle events
-template<class T, size_t Uuid = 0>
-struct lifecycle_logger : lifecycle_default_logger<T, Uuid>
-{};
-
-
-// Namespace for internal implementation details
 namespace intl
 {
-    // Base class for tracking lifecycle events
-    template<class Derived, class T, size_t Uuid>
-    class lifecycle_tracker_base
+    // Content of a sink slot: a qs::lifecycle_sink pointer or one of the states below.
+    // Zero means unresolved, so slots work before dynamic initialization has run.
+    enum lifecycle_sink_state : std::uintptr_t
+    {
+        sink_unresolved = 0,
+        sink_inherit    = 1,
+        sink_off        = 2
+    };
+
+    QS_INLINE std::uintptr_t encode_sink(lifecycle_sink* sink) noexcept
     {
-        static_assert(std::is_class<T>::value, "T must be a class type");
+        return sink == nullptr ? sink_off : reinterpret_cast<std::uintptr_t>(sink);
+    }
+
+    // Global sink settings, templated to keep them header-only
+    template<class Dummy = void>
+    struct lifecycle_sink_globals
+    {
+        QS_INLINE_VAR static std::atomic<std::uintptr_t> default_sink QS_INLINE_VAR_INIT({});
+        QS_INLINE_VAR static std::atomic<size_t>         batch_size
+            QS_INLINE_VAR_INIT({QS_LIFECYCLE_SINK_BATCH_SIZE});
+        // Set once the environment is applied, after which registering types check their sink
+        QS_INLINE_VAR static std::atomic<bool> env_applied QS_INLINE_VAR_INIT({});
+    };
 
+#if !defined(__cpp_inline_variables)
+    template<class Dummy>
+    std::atomic<std::uintptr_t> lifecycle_sink_globals<Dummy>::default_sink{};
+    template<class Dummy>
+    std::atomic<bool> lifecycle_sink_globals<Dummy>::env_applied{};
+    template<class Dummy>
+    std::atomic<size_t> lifecycle_sink_globals<Dummy>::batch_size{QS_LIFECYCLE_SINK_BATCH_SIZE};
+#endif
+
+    // Per-thread batch of formatted lines waiting to be written to a single sink
+    class lifecycle_log_buffer
+    {
     public:
-        // Constructor
-        QS_CONSTEXPR20 lifecycle_tracker_base()
+        lifecycle_log_buffer() = default;
+
+        lifecycle_log_buffer(lifecycle_log_buffer const&)            = delete;
+        lifecycle_log_buffer& operator=(lifecycle_log_buffer const&) = delete;
+
+        ~lifecycle_log_buffer()
         {
-            log_and_increment<lifecycle_event::Constructor>();
+            flush(false);
+            destroyed_() = true;
         }
 
-        // Copy constructor
-        QS_CONSTEXPR20 lifecycle_tracker_base(lifecycle_tracker_base const&)
+        // Buffer of the calling thread, or nullptr once it has been destroyed at thread exit
+        static lifecycle_log_buffer* local()
         {
-            log_and_increment<lifecycle_event::CopyConstructor>();
+            if(QS_UNLIKELY(destroyed_()))
+                return nullptr;
+            static thread_local lifecycle_log_buffer buffer;
+            return &buffer;
         }
 
-        // Copy assignment operator
-        QS_CONSTEXPR20 lifecycle_tracker_base& operator=(lifecycle_tracker_base const& other)
+        // Text appended to the returned string is written to the sink
+        std::string& acquire(lifecycle_sink* sink)
         {
-            if(this != std::addressof(other))
-                log_and_increment<lifecycle_event::CopyAssignment>();
-            return *this;
+            if(sink != sink_)
+            {
+                flush(false);
+                sink_ = sink;
+            }
+            return data_;
         }
 
-        // Move constructor
-        QS_CONSTEXPR20 lifecycle_tracker_base(lifecycle_tracker_base&&)
+        // Write the pending text once the batch is full, or right away if forced
+        void release(bool force)
         {
-            log_and_increment<lifecycle_event::MoveConstructor>();
+            if(force ||
+               data_.size() >= lifecycle_sink_globals<>::batch_size.load(std::memory_order_relaxed))
+                flush(force);
         }
 
-        // Move assignment operator
-        QS_CONSTEXPR20 lifecycle_tracker_base& operator=(lifecycle_tracker_base&& other)
+        // Write the pending text, optionally flushing the sink itself
+        void flush(bool flush_sink)
         {
-            if(this != std::addressof(other))
-                log_and_increment<lifecycle_event::MoveAssignment>();
-            return *this;
+            if(sink_ == nullptr)
+                return;
+            if(!data_.empty())
+                sink_->write(data_.data(), data_.size());
+            if(flush_sink)
+                sink_->flush();
+            data_.clear();
         }
 
-        // Destructor
-        QS_CONSTEXPR20 ~lifecycle_tracker_base()
+        // Flush and forget the sink, so that it can be destroyed
+        void detach()
         {
-            log_and_increment<lifecycle_event::Destructor>();
+            flush(true);
+            sink_ = nullptr;
         }
 
-        // Reset lifecycle counters
-        static QS_CONSTEXPR17 void reset_counters() { counters_ = lifecycle_counters{}; }
-
-        // Get lifecycle counters
-        static QS_CONSTEXPR14 lifecycle_counters const& get_counters() { return counters_; }
+    private:
+        lifecycle_sink* sink_ = nullptr;
+        std::string     data_;
 
-        // Print lifecycle counters
-        static QS_CONSTEXPR14 lifecycle_counters const& print_counters()
+        // Trivially destructible, so it is still valid after the buffer is gone
+        static bool& destroyed_() noexcept
         {
-            lifecycle_counters const& cnts = get_counters();
-            logger_.print_counters(cnts, get_type_name());
-            return cnts;
+            static thread_local bool destroyed = false;
+            return destroyed;
         }
+    };
 
-#if defined(__cpp_lib_string_view)
-        // Set type name using string_view
-        static QS_CONSTEXPR17 void set_type_name(std::string_view const type_name)
-        {
-            type_name_ = type_name;
-        }
-#else
-        // Set type name using char array
-        template<size_t N>
-        static QS_CONSTEXPR17 void set_type_name(char const (&type_name)[N])
+    // A log record formatted into the thread's buffer and committed on destruction
+    class lifecycle_log_line
+    {
+    public:
+        explicit lifecycle_log_line(lifecycle_sink* sink, bool flush = false)
+            : buffer_{lifecycle_log_buffer::local()},
+              sink_{sink},
+              flush_{flush},
+              out_{buffer_ != nullptr ? &buffer_->acquire(sink) : &fallback_}
+        {}
+
+        lifecycle_log_line(lifecycle_log_line const&)            = delete;
+        lifecycle_log_line& operator=(lifecycle_log_line const&) = delete;
+
+        ~lifecycle_log_line()
         {
-            type_name_.assign(type_name, N - 1);
+            if(buffer_ != nullptr)
+            {
+                buffer_->release(flush_);
+                return;
+            }
+            sink_->write(fallback_.data(), fallback_.size());
+            if(flush_)
+                sink_->flush();
+        }
+
+        std::string& str() noexcept { return *out_; }
+
+    private:
+        lifecycle_log_buffer* buffer_;
+        lifecycle_sink*       sink_;
+        bool                  flush_;
+        std::string           fallback_;
+        std::string*          out_;
+    };
+
+    template<class T, size_t Uuid>
+    struct lifecycle_sink_slot;
+
+    // Let every registered type check its sink again, defined after qs::lifecycle_registry
+    template<class Dummy = void>
+    struct lifecycle_sink_refresh
+    {
+        static void all();
+    };
+} // namespace intl
+
+
+// Runtime selection of the sinks used by qs::lifecycle_default_logger. Every type logs to the
+// default sink unless it has its own, and a null sink disables logging for it.
+class lifecycle_sinks
+{
+    using globals = intl::lifecycle_sink_globals<>;
+
+public:
+    static lifecycle_sink* stdout_sink()
+    {
+        static auto* const sink = new lifecycle_file_sink{stdout};
+        return sink;
+    }
+
+    static lifecycle_sink* stderr_sink()
+    {
+        static auto* const sink = new lifecycle_file_sink{stderr};
+        return sink;
+    }
+
+    // Sink of every type without its own (nullptr when logging is disabled)
+    static lifecycle_sink* get_default()
+    {
+        std::uintptr_t const s = globals::default_sink.load(std::memory_order_acquire);
+        if(QS_UNLIKELY(s == intl::sink_unresolved))
+            return resolve_default_();
+        return decode_(s);
+    }
+
+    // Set the default sink (nullptr disables logging)
+    static void set_default(lifecycle_sink* sink);
+
+    // Create a sink from its spec: "null", "stdout", "stderr", "file:<path>", "ring[:<bytes>]"
+    // or "syslog[:<ident>]". Created sinks live until the end of the program.
+    static bool make(std::string const& spec, lifecycle_sink*& sink);
+
+    // Configure the sinks from "<default spec>;<type name>=<spec>;...", the format of the
+    // QS_LIFECYCLE_SINK environment variable. Types resolve their sink again on their next
+    // event, dropping sinks set in code. Returns false if any entry was invalid.
+    static bool configure(std::string const& config);
+
+    // Number of bytes buffered per thread before writing to the sink (0, the default, writes
+    // every line)
+    static void set_batch_size(size_t bytes)
+    {
+        globals::batch_size.store(bytes, std::memory_order_relaxed);
+    }
+    static size_t get_batch_size() { return globals::batch_size.load(std::memory_order_relaxed); }
+
+    // Write the lines buffered by the calling thread. Call it on every logging thread before
+    // destroying a sink.
+    static void flush()
+    {
+        if(intl::lifecycle_log_buffer* const buffer = intl::lifecycle_log_buffer::local())
+            buffer->detach();
+    }
+
+private:
+    template<class, size_t>
+    friend struct intl::lifecycle_sink_slot;
+
+    struct state_t;
+
+    // Never destroyed, since tracked objects with static storage may log during exit
+    static state_t& state_();
+
+    static lifecycle_sink* decode_(std::uintptr_t s) noexcept
+    {
+        return s == intl::sink_off ? nullptr : reinterpret_cast<lifecycle_sink*>(s);
+    }
+
+    static bool make_(state_t& st, std::string const& spec, lifecycle_sink*& sink);
+
+    // Configure without refreshing the types, which resolve their sink through get_default().
+    // Unless `replace`, the sinks set in code are kept, default and per-type ones alike.
+    static bool configure_(std::string const& config, bool replace);
+
+    // Apply QS_LIFECYCLE_SINK once, before the first sink is used, set or configured in code,
+    // so that it never replaces them. The registered types then check their sink, so that the
+    // ones it turns off skip logging on their inlined path. The default is resolved first, so
+    // that checking does not come back here.
+    static void apply_env_();
+
+    // Track a slot set in code, so that configure() resets it as well
+    static void track_slot_(std::atomic<std::uintptr_t>& slot);
+
+    // Apply QS_LIFECYCLE_SINK on first use, falling back to stdout
+    static lifecycle_sink* resolve_default_();
+
+    // Resolve a per-type slot from the configured overrides
+    static lifecycle_sink* resolve_slot_(std::atomic<std::uintptr_t>& slot,
+                                         std::string const&           type_name);
+};
+
+#if !QS_LIFECYCLE_DECLARE_ONLY
+struct lifecycle_sinks::state_t
+{
+    std::mutex                                   mutex;
+    std::vector<std::unique_ptr<lifecycle_sink>> owned;
+    std::map<std::string, std::uintptr_t>        overrides;
+    std::vector<std::atomic<std::uintptr_t>*>    slots;
+};
+
+QS_LIFECYCLE_API lifecycle_sinks::state_t& lifecycle_sinks::state_()
+{
+    static auto* const st = new state_t{};
+    return *st;
+}
+
+QS_LIFECYCLE_API void lifecycle_sinks::set_default(lifecycle_sink* sink)
+{
+    apply_env_();
+    globals::default_sink.store(intl::encode_sink(sink), std::memory_order_release);
+    intl::lifecycle_sink_refresh<>::all();
+}
+
+QS_LIFECYCLE_API bool lifecycle_sinks::make(std::string const& spec, lifecycle_sink*& sink)
+{
+    state_t&                    st = state_();
+    std::lock_guard<std::mutex> lock{st.mutex};
+    return make_(st, spec, sink);
+}
+
+QS_LIFECYCLE_API bool lifecycle_sinks::configure(std::string const& config)
+{
+    apply_env_();
+    bool const ok = configure_(config, true);
+    intl::lifecycle_sink_refresh<>::all();
+    return ok;
+}
+
+QS_LIFECYCLE_API bool lifecycle_sinks::make_(state_t& st, std::string const& spec,
+                                             lifecycle_sink*& sink)
+{
+    auto const has_prefix = [&spec](char const* prefix)
+    { return spec.compare(0, std::strlen(prefix), prefix) == 0; };
+
+    if(spec == "null" || spec == "off")
+        sink = nullptr;
+    else if(spec == "stdout")
+        sink = stdout_sink();
+    else if(spec == "stderr")
+        sink = stderr_sink();
+    else if(has_prefix("file:"))
+    {
+        std::unique_ptr<lifecycle_file_sink> file{new lifecycle_file_sink{spec.c_str() + 5}};
+        if(!file->is_open())
+            return false;
+        sink = file.get();
+        st.owned.push_back(std::move(file));
+    }
+    else if(spec == "ring" || has_prefix("ring:"))
+    {
+        size_t const capacity =
+            spec.size() > 5 ? std::strtoull(spec.c_str() + 5, nullptr, 10) : 1 << 16;
+        st.owned.emplace_back(new lifecycle_ring_sink{capacity});
+        sink = st.owned.back().get();
+    }
+    else if(spec == "syslog" || has_prefix("syslog:"))
+    {
+        st.owned.emplace_back(spec.size() > 7 ? new lifecycle_syslog_sink{spec.substr(7)}
+                                              : new lifecycle_syslog_sink{});
+        sink = st.owned.back().get();
+    }
+    else
+        return false;
+    return true;
+}
+
+QS_LIFECYCLE_API bool lifecycle_sinks::configure_(std::string const& config, bool replace)
+{
+    state_t&                    st = state_();
+    std::lock_guard<std::mutex> lock{st.mutex};
+
+    bool ok = true;
+    st.overrides.clear();
+    for(size_t pos = 0; pos <= config.size();)
+    {
+        size_t end = config.find(';', pos);
+        if(end == std::string::npos)
+            end = config.size();
+        std::string const entry = config.substr(pos, end - pos);
+        pos                     = end + 1;
+        if(entry.empty())
+            continue;
+
+        size_t const    eq   = entry.find('=');
+        lifecycle_sink* sink = nullptr;
+        if(!make_(st, eq == std::string::npos ? entry : entry.substr(eq + 1), sink))
+            ok = false;
+        else if(eq == std::string::npos && replace)
+            globals::default_sink.store(intl::encode_sink(sink), std::memory_order_release);
+        else if(eq == std::string::npos)
+        {
+            std::uintptr_t expected = intl::sink_unresolved;
+            globals::default_sink.compare_exchange_strong(
+                expected, intl::encode_sink(sink), std::memory_order_acq_rel);
+        }
+        else
+            st.overrides[entry.substr(0, eq)] = intl::encode_sink(sink);
+    }
+
+    if(replace)
+    {
+        for(std::atomic<std::uintptr_t>* slot : st.slots)
+            slot->store(intl::sink_unresolved, std::memory_order_release);
+        st.slots.clear();
+    }
+    return ok;
+}
+
+QS_LIFECYCLE_API void lifecycle_sinks::apply_env_()
+{
+    static bool const applied = []
+    {
+        if(char const* const env = std::getenv(QS_LIFECYCLE_SINK_ENV))
+            configure_(env, false);
+        std::uintptr_t expected = intl::sink_unresolved;
+        globals::default_sink.compare_exchange_strong(
+            expected, intl::encode_sink(stdout_sink()), std::memory_order_acq_rel);
+        // set before checking, so that a type registering meanwhile is checked either here
+        // or by its own registration
+        globals::env_applied.store(true, std::memory_order_seq_cst);
+        intl::lifecycle_sink_refresh<>::all();
+        return true;
+    }();
+    static_cast<void>(applied);
+}
+
+QS_LIFECYCLE_API void lifecycle_sinks::track_slot_(std::atomic<std::uintptr_t>& slot)
+{
+    state_t&                    st = state_();
+    std::lock_guard<std::mutex> lock{st.mutex};
+    if(std::find(st.slots.begin(), st.slots.end(), &slot) == st.slots.end())
+        st.slots.push_back(&slot);
+}
+
+QS_LIFECYCLE_API lifecycle_sink* lifecycle_sinks::resolve_default_()
+{
+    apply_env_();
+    return get_default();
+}
+
+QS_LIFECYCLE_API lifecycle_sink* lifecycle_sinks::resolve_slot_(
+    std::atomic<std::uintptr_t>& slot, std::string const& type_name)
+{
+    lifecycle_sink* const def = get_default(); // applies the environment first
+    {
+        state_t&                    st = state_();
+        std::lock_guard<std::mutex> lock{st.mutex};
+
+        auto const           it = st.overrides.find(type_name);
+        std::uintptr_t const value =
+            it != st.overrides.end() ? it->second : std::uintptr_t{intl::sink_inherit};
+        std::uintptr_t expected = intl::sink_unresolved;
+        if(slot.compare_exchange_strong(expected, value, std::memory_order_acq_rel))
+            st.slots.push_back(&slot);
+    }
+    std::uintptr_t const s = slot.load(std::memory_order_acquire);
+    return s == intl::sink_inherit || s == intl::sink_unresolved ? def : decode_(s);
+}
+#endif
+
+
+namespace intl
+{
+    // Sink of a tracked type, shared by qs::lifecycle_tracker and qs::lifecycle_tracker_mt
+    template<class T, size_t Uuid>
+    struct lifecycle_sink_slot
+    {
+        // Current sink, nullptr when logging is disabled for the type
+        static lifecycle_sink* get(std::string const& type_name)
+        {
+            std::uintptr_t const s = value_.load(std::memory_order_acquire);
+            if(QS_LIKELY(s == sink_inherit))
+                return lifecycle_sinks::get_default();
+            if(QS_UNLIKELY(s == sink_unresolved))
+                return lifecycle_sinks::resolve_slot_(value_, type_name);
+            return lifecycle_sinks::decode_(s);
+        }
+
+        static void set(lifecycle_sink* sink)
+        {
+            lifecycle_sinks::apply_env_();
+            value_.store(encode_sink(sink), std::memory_order_release);
+            lifecycle_sinks::track_slot_(value_);
+        }
+
+        static void reset() { value_.store(sink_unresolved, std::memory_order_release); }
+
+    private:
+        QS_INLINE_VAR static std::atomic<std::uintptr_t> value_ QS_INLINE_VAR_INIT({});
+    };
+
+#if !defined(__cpp_inline_variables)
+    template<class T, size_t Uuid>
+    std::atomic<std::uintptr_t> lifecycle_sink_slot<T, Uuid>::value_{};
+#endif
+} // namespace intl
+
+QS_NAMESPACE_END
+
+
+// -----------------------------------------------------------------------------
+// lifecycle_tracker
+// -----------------------------------------------------------------------------
+
+
+// Events tracked when the program starts, as a qs::lifecycle_event_mask (all by default).
+// Use 0 to ship tracking disabled and enable it per type at runtime.
+#ifndef QS_LIFECYCLE_TRACKER_ENABLED_EVENTS
+#define QS_LIFECYCLE_TRACKER_ENABLED_EVENTS 0x3fu
+#endif
+
+// Count events during constant evaluation in a qs::lifecycle_constexpr_context (C++20).
+// Adds a pointer to every tracker, so it is off by default.
+#ifndef QS_LIFECYCLE_TRACKER_CONSTEXPR
+#define QS_LIFECYCLE_TRACKER_CONSTEXPR 0
+#endif
+#if QS_LIFECYCLE_TRACKER_CONSTEXPR && !QS_USE_CONSTEVAL
+#error "QS_LIFECYCLE_TRACKER_CONSTEXPR requires C++20 std::is_constant_evaluated"
+#endif
+
+// Capture construction stacks for the leak report with backtrace(3)
+#ifdef QS_LIFECYCLE_TRACKER_WITH_BACKTRACE
+// user provided option
+#elif QS_HAS_INCLUDE(<execinfo.h>)
+#define QS_LIFECYCLE_TRACKER_WITH_BACKTRACE 1
+#else
+#define QS_LIFECYCLE_TRACKER_WITH_BACKTRACE 0
+#endif
+#if QS_LIFECYCLE_TRACKER_WITH_BACKTRACE
+#include <execinfo.h>
+#endif
+
+// Maximum number of tracked types in qs::lifecycle_registry
+#ifndef QS_LIFECYCLE_REGISTRY_CAPACITY
+#define QS_LIFECYCLE_REGISTRY_CAPACITY 4096
+#endif
+
+// Environment variable naming a file where the counters of every type are dumped at exit
+#ifndef QS_LIFECYCLE_DUMP_ENV
+#define QS_LIFECYCLE_DUMP_ENV "QS_LIFECYCLE_DUMP"
+#endif
+
+// Dump the counters from a signal handler with qs::lifecycle_signal_dump (POSIX)
+#ifdef QS_LIFECYCLE_TRACKER_WITH_SIGNAL_DUMP
+// user provided option
+#elif QS_HAS_INCLUDE(<signal.h>) && QS_HAS_INCLUDE(<unistd.h>)
+#define QS_LIFECYCLE_TRACKER_WITH_SIGNAL_DUMP 1
+#else
+#define QS_LIFECYCLE_TRACKER_WITH_SIGNAL_DUMP 0
+#endif
+#if QS_LIFECYCLE_TRACKER_WITH_SIGNAL_DUMP && !QS_LIFECYCLE_DECLARE_ONLY
+#include <cerrno>
+#include <signal.h>
+#include <unistd.h>
+#endif
+
+// Frames kept per construction stack, and number of distinct stacks interned
+#ifndef QS_LIFECYCLE_STACK_DEPTH
+#define QS_LIFECYCLE_STACK_DEPTH 16
+#endif
+#ifndef QS_LIFECYCLE_STACK_CAPACITY
+#define QS_LIFECYCLE_STACK_CAPACITY 16384
+#endif
+
+// Events of a type on a thread after a copy within which destroying the source reports a
+// missed move
+#ifndef QS_LIFECYCLE_MISSED_MOVE_WINDOW
+#define QS_LIFECYCLE_MISSED_MOVE_WINDOW 8
+#endif
+
+// Read hardware counters around the copies and moves of tracked types, once enabled with
+// set_perf_counters_enabled(). Adds a check to every copy and move, so it is off by default.
+#ifndef QS_LIFECYCLE_TRACKER_PERF
+#define QS_LIFECYCLE_TRACKER_PERF 0
+#endif
+
+// Read the hardware counters with perf_event_open(2), otherwise copies and moves are only counted
+#ifdef QS_LIFECYCLE_TRACKER_WITH_PERF_EVENT
+// user provided option
+#elif QS_LIFECYCLE_TRACKER_PERF && QS_HAS_INCLUDE(<linux/perf_event.h>)
+#define QS_LIFECYCLE_TRACKER_WITH_PERF_EVENT 1
+#else
+#define QS_LIFECYCLE_TRACKER_WITH_PERF_EVENT 0
+#endif
+#if QS_LIFECYCLE_TRACKER_WITH_PERF_EVENT && !QS_LIFECYCLE_DECLARE_ONLY
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Nesting depth of measured copies and moves on one thread, deeper ones are only counted
+#ifndef QS_LIFECYCLE_PERF_DEPTH
+#define QS_LIFECYCLE_PERF_DEPTH 16
+#endif
+
+// Maximum number of distinct task names counted by qs::lifecycle_task_context
+#ifndef QS_LIFECYCLE_TASK_CAPACITY
+#define QS_LIFECYCLE_TASK_CAPACITY 64
+#endif
+
+// Define logging macros based on available libraries, formatting into a std::string
+#if QS_LIFECYCLE_DECLARE_ONLY
+// formatted out of line
+#elif QS_LIFECYCLE_TRACKER_FORMAT == 1
+#include <fmt/core.h>
+#include <fmt/format.h>
+#define QS_LIFECYCLE_LOGGER_FORMAT_TO(out, ...) fmt::format_to(std::back_inserter(out), __VA_ARGS__)
+#define QS_LIFECYCLE_LOGGER_STRING_ARG(x) x
+#elif QS_LIFECYCLE_TRACKER_FORMAT == 2
+#include <format>
+#include <print>
+#define QS_LIFECYCLE_LOGGER_FORMAT_TO(out, ...) std::format_to(std::back_inserter(out), __VA_ARGS__)
+#define QS_LIFECYCLE_LOGGER_STRING_ARG(x) x
+#else
+#include <cstdarg>
+#define QS_LIFECYCLE_LOGGER_FORMAT_TO(out, ...)                                                    \
+    ::QS_NAMESPACE::intl::format_to_printf(out, __VA_ARGS__)
+#define QS_LIFECYCLE_LOGGER_STRING_ARG(x) static_cast<int>(x.size()), x.data()
+
+QS_NAMESPACE_BEGIN
+
+namespace intl
+{
+    // Append printf-style formatted text to a string
+    inline void format_to_printf(std::string& out, char const* format, ...)
+    {
+        va_list args;
+        va_list args_copy;
+        va_start(args, format);
+        va_copy(args_copy, args);
+        int const size = std::vsnprintf(nullptr, 0, format, args_copy);
+        va_end(args_copy);
+        if(size > 0)
+        {
+            size_t const pos = out.size();
+            out.resize(pos + static_cast<size_t>(size) + 1);
+            std::vsnprintf(&out[pos], static_cast<size_t>(size) + 1, format, args);
+            out.resize(pos + static_cast<size_t>(size));
+        }
+        va_end(args);
+    }
+} // namespace intl
+
+QS_NAMESPACE_END
+#endif
+
+
+QS_NAMESPACE_BEGIN
+
+// Enum to represent different lifecycle events
+enum class lifecycle_event
+{
+    Constructor     = 0,
+    CopyConstructor = 1,
+    MoveConstructor = 2,
+    CopyAssignment  = 3,
+    MoveAssignment  = 4,
+    Destructor      = 5
+};
+
+// Bit mask of lifecycle events, used to switch tracking on and off at runtime
+using lifecycle_event_mask = unsigned;
+
+constexpr lifecycle_event_mask lifecycle_all_events = 0x3fu;
+
+constexpr lifecycle_event_mask lifecycle_event_bit(lifecycle_event event) noexcept
+{
+    return 1u << static_cast<unsigned>(event);
+}
+
+// Struct to hold lifecycle counters
+struct lifecycle_counters
+{
+    size_t constructor;
+    size_t copy_constructor;
+    size_t move_constructor;
+    size_t copy_assignment;
+    size_t move_assignment;
+    size_t destructor;
+
+    // Methods to calculate total constructed, assigned, and alive objects
+    constexpr size_t total_constructed() const noexcept
+    {
+        return constructor + copy_constructor + move_constructor;
+    }
+    constexpr size_t total_assigned() const noexcept { return copy_assignment + move_assignment; }
+    constexpr ptrdiff_t alive() const noexcept
+    {
+        return static_cast<ptrdiff_t>(total_constructed()) - static_cast<ptrdiff_t>(destructor);
+    }
+
+    // Add the counters of other events
+    QS_CONSTEXPR14 lifecycle_counters& operator+=(lifecycle_counters const& rhs) noexcept
+    {
+        constructor += rhs.constructor;
+        copy_constructor += rhs.copy_constructor;
+        move_constructor += rhs.move_constructor;
+        copy_assignment += rhs.copy_assignment;
+        move_assignment += rhs.move_assignment;
+        destructor += rhs.destructor;
+        return *this;
+    }
+
+    // Equality operator for lifecycle_counters
+    constexpr bool operator==(lifecycle_counters const& rhs) const noexcept
+    {
+        return constructor == rhs.constructor && copy_constructor == rhs.copy_constructor &&
+               move_constructor == rhs.move_constructor && copy_assignment == rhs.copy_assignment &&
+               move_assignment == rhs.move_assignment && destructor == rhs.destructor;
+    }
+};
+
+
+namespace intl
+{
+    inline namespace QS_LIFECYCLE_ABI
+    {
+        // Format strings of the default logger, for the formatting library in use. A counters
+        // report is a title line and the counter lines, in `counters` for the default title.
+        template<class Dummy = void>
+        struct lifecycle_formats
+        {
+#if QS_LIFECYCLE_TRACKER_FORMAT != 0
+#define QS_LIFECYCLE_COUNTER_LINES_                                                                \
+    " * constructor (ctor/copy/move) : {:>5} ({}/{}/{})\n"                                         \
+    " * assign (copy/move)           : {:>5} ({}/{})\n"                                            \
+    " * destructor (alive)           : {:>5} ({})\n"
+            QS_INLINE_VAR static constexpr std::array<char const*, 6> event{
+                "{}(...)", "{}({} const&)", "{}({}&&)", "=({} const&)", "=({}&&)", "~{}()"};
+            QS_INLINE_VAR static constexpr char const* title = "{} [type: {}, uuid: {}]\n";
+#else
+#define QS_LIFECYCLE_COUNTER_LINES_                                                                \
+    " * constructor (ctor/copy/move) : %5zu (%zu/%zu/%zu)\n"                                       \
+    " * assign (copy/move)           : %5zu (%zu/%zu)\n"                                           \
+    " * destructor (alive)           : %5zu (%td)\n"
+            QS_INLINE_VAR static constexpr std::array<char const*, 6> event{
+                "%.*s(...)",       "%.*s(%.*s const&)", "%.*s(%.*s&&)",
+                "=(%.*s const&)", "=(%.*s&&)",         "~%.*s()"};
+            QS_INLINE_VAR static constexpr char const* title = "%s [type: %.*s, uuid: %zu]\n";
+#endif
+            QS_INLINE_VAR static constexpr char const* lines = QS_LIFECYCLE_COUNTER_LINES_;
+#if QS_LIFECYCLE_TRACKER_FORMAT != 0
+            QS_INLINE_VAR static constexpr char const* counters =
+                "Lifecycle tracker [type: {}, uuid: {}]\n" QS_LIFECYCLE_COUNTER_LINES_;
+#else
+            QS_INLINE_VAR static constexpr char const* counters =
+                "Lifecycle tracker [type: %.*s, uuid: %zu]\n" QS_LIFECYCLE_COUNTER_LINES_;
+#endif
+#undef QS_LIFECYCLE_COUNTER_LINES_
+        };
+
+#if !defined(__cpp_inline_variables)
+        template<class Dummy>
+        constexpr std::array<char const*, 6> lifecycle_formats<Dummy>::event;
+        template<class Dummy>
+        constexpr char const* lifecycle_formats<Dummy>::title;
+        template<class Dummy>
+        constexpr char const* lifecycle_formats<Dummy>::lines;
+        template<class Dummy>
+        constexpr char const* lifecycle_formats<Dummy>::counters;
+#endif
+
+#if !QS_LIFECYCLE_DECLARE_ONLY
+        template<lifecycle_event Cnt>
+        void format_event_(std::string& out, std::string const& type_name)
+        {
+            QS_LIFECYCLE_LOGGER_FORMAT_TO(out, lifecycle_formats<>::event[static_cast<size_t>(Cnt)],
+                                          QS_LIFECYCLE_LOGGER_STRING_ARG(type_name),
+                                          QS_LIFECYCLE_LOGGER_STRING_ARG(type_name));
+        }
+#endif
+
+        // Append the log line of an event of the default logger, without the newline
+        QS_LIFECYCLE_API void format_event(std::string& out, lifecycle_event event,
+                                           std::string const& type_name)
+#if QS_LIFECYCLE_DECLARE_ONLY
+            ;
+#else
+        {
+            switch(event)
+            {
+                case lifecycle_event::Constructor:
+                    return format_event_<lifecycle_event::Constructor>(out, type_name);
+                case lifecycle_event::CopyConstructor:
+                    return format_event_<lifecycle_event::CopyConstructor>(out, type_name);
+                case lifecycle_event::MoveConstructor:
+                    return format_event_<lifecycle_event::MoveConstructor>(out, type_name);
+                case lifecycle_event::CopyAssignment:
+                    return format_event_<lifecycle_event::CopyAssignment>(out, type_name);
+                case lifecycle_event::MoveAssignment:
+                    return format_event_<lifecycle_event::MoveAssignment>(out, type_name);
+                case lifecycle_event::Destructor:
+                    return format_event_<lifecycle_event::Destructor>(out, type_name);
+            }
+        }
+#endif
+
+        // Append the counters report of the default logger, under another title if given
+        QS_LIFECYCLE_API void format_counters(std::string& out, lifecycle_counters const& cnts,
+                                              std::string const& type_name, size_t uuid,
+                                              char const* title = "Lifecycle tracker")
+#if QS_LIFECYCLE_DECLARE_ONLY
+            ;
+#else
+        {
+            QS_LIFECYCLE_LOGGER_FORMAT_TO(out, lifecycle_formats<>::title, title,
+                                          QS_LIFECYCLE_LOGGER_STRING_ARG(type_name), uuid);
+            QS_LIFECYCLE_LOGGER_FORMAT_TO(out, lifecycle_formats<>::lines,
+                                          cnts.total_constructed(), cnts.constructor,
+                                          cnts.copy_constructor, cnts.move_constructor,
+                                          cnts.total_assigned(), cnts.copy_assignment,
+                                          cnts.move_assignment, cnts.destructor, cnts.alive());
+        }
+#endif
+    } // namespace QS_LIFECYCLE_ABI
+} // namespace intl
+
+
+// Counters of the trackers constructed with it during constant evaluation, where the static
+// counters cannot be used. Requires QS_LIFECYCLE_TRACKER_CONSTEXPR.
+//
+//     constexpr bool no_copies = [] {
+//         qs::lifecycle_constexpr_context ctx;
+//         std::array<qs::lifecycle_tracker<Point>, 2> v{{{ctx, 1, 2}, {ctx, 3, 4}}};
+//         std::swap(v[0], v[1]);
+//         return ctx.counters().copy_constructor == 0;
+//     }();
+//
+// Copies and moves count in the context of their source, and assignments in the one of their
+// target, or of their source if the target has none.
+class lifecycle_constexpr_context
+{
+public:
+    constexpr lifecycle_counters const& counters() const noexcept { return counters_; }
+
+    template<lifecycle_event Cnt>
+    QS_CONSTEXPR14 void increment() noexcept
+    {
+        ++std::get<static_cast<size_t>(Cnt)>(std::tie(
+            counters_.constructor, counters_.copy_constructor, counters_.move_constructor,
+            counters_.copy_assignment, counters_.move_assignment, counters_.destructor));
+    }
+
+private:
+    lifecycle_counters counters_{};
+};
+
+
+// clang-format off
+//
+// The qs::lifecycle_logger struct is a template that provides logging functionality for lifecycle events
+// of a given type T and a unique identifier Uuid to distinguish between different lifecycle_trackers.
+// The default logger is qs::lifecycle_default_logger which should not be modified.
+// The user can provide a custom logger by template specialization of qs::lifecycle_logger.
+// The default logger formats into a per-thread buffer written line by line, or in opt-in
+// batches, to a qs::lifecycle_sink selected at runtime through qs::lifecycle_sinks or set_sink()
+// on the tracker.
+// NOTE: Custom loggers are not synchronized by either qs::lifecycle_tracker or
+// qs::lifecycle_tracker_mt.
+//
+//
+// template<class T, size_t Uuid = 0>
+// struct lifecycle_logger
+// {
+//     using value_type      = T; // The type being tracked
+//     using reference       = value_type&; // Reference to the type
+//     using const_reference = value_type const&; // Const reference to the type
+//     using pointer         = value_type*; // Pointer to the type
+//     using const_pointer   = value_type const*; // Const pointer to the type
+
+//     // Logs a specific lifecycle event for the given type instance
+//     template<lifecycle_event Cnt>
+//     QS_CONSTEXPR17 void log_event(const_reference self, std::string const& type_name) const;
+
+//     // Prints the current lifecycle counters for the given type
+//     QS_CONSTEXPR17 void print_counters(lifecycle_counters const& cnts,
+//                                        std::string const&        type_name) const;
+// };
+//
+// clang-format on
+
+
+// Default logger for lifecycle events
+template<class T, size_t Uuid = 0>
+struct lifecycle_default_logger
+{
+    using value_type      = T;
+    using reference       = value_type&;
+    using const_reference = value_type const&;
+    using pointer         = value_type*;
+    using const_pointer   = value_type const*;
+
+    // Log lifecycle event
+    template<lifecycle_event Cnt>
+    void log_event(const_reference self, std::string const& type_name) const
+    {
+        intl::ignore_unused(self);
+        lifecycle_sink* const sink = intl::lifecycle_sink_slot<T, Uuid>::get(type_name);
+        if(sink == nullptr)
+            return;
+
+        intl::lifecycle_log_line line{sink};
+        intl::format_event(line.str(), Cnt, type_name);
+        line.str().push_back('\n');
+    }
+
+    // Print lifecycle counters, flushing the sink
+    void print_counters(lifecycle_counters const& cnts, std::string const& type_name) const
+    {
+        lifecycle_sink* const sink = intl::lifecycle_sink_slot<T, Uuid>::get(type_name);
+        if(sink == nullptr)
+            return;
+
+        intl::lifecycle_log_line line{sink, true};
+        intl::format_counters(line.str(), cnts, type_name, Uuid);
+    }
+
+protected:
+    // Get format string for logging events
+    template<lifecycle_event Cnt>
+    QS_INLINE static QS_CONSTEXPR14 char const* log_event_format()
+    {
+        return intl::lifecycle_formats<>::event[static_cast<size_t>(Cnt)];
+    }
+
+    // Get format string for logging counters
+    QS_INLINE static QS_CONSTEXPR14 char const* log_counters_format()
+    {
+        return intl::lifecycle_formats<>::counters;
+    }
+};
+
+
+// Logger for lifecycle events
+template<class T, size_t Uuid>
+struct lifecycle_logger : lifecycle_default_logger<T, Uuid>
+{
+    // Only set by this primary template, so that the trackers can log through
+    // qs::intl::log_default_event unless the logger is customized
+    using default_logger_tag = void;
+};
+
+
+// Filter of the logged events of a type. Specialize it to log only the events of expensive
+// values, which are also counted by get_heavy_counters():
+//
+//     template<size_t Uuid>
+//     struct qs::lifecycle_log_filter<std::string, Uuid>
+//     {
+//         bool operator()(std::string const& str) const { return str.size() > 4096; }
+//     };
+//
+// The filter is only called while logging is enabled, set_log_filter() replaces it at runtime.
+template<class T, size_t Uuid>
+struct lifecycle_log_filter
+{
+    // Only set by this primary template, which logs every event
+    using default_filter_tag = void;
+
+    QS_CONSTEXPR14 bool operator()(T const&) const noexcept { return true; }
+};
+
+
+namespace intl
+{
+    // Type-erased access to the name and sink of a tracked type for the default logger
+    struct lifecycle_type_descriptor
+    {
+        std::string const& (*type_name)();
+        lifecycle_sink* (*sink)();
+    };
+
+    inline namespace QS_LIFECYCLE_ABI
+    {
+        // Log an event with the default logger. A single cold function shared by every tracked
+        // type, so that trackers only inline the counter increment and a call.
+        QS_COLD QS_NOINLINE QS_LIFECYCLE_API void
+        log_default_event(lifecycle_type_descriptor const& type, lifecycle_event event)
+#if QS_LIFECYCLE_DECLARE_ONLY
+            ;
+#else
+        {
+            lifecycle_sink* const sink = type.sink();
+            if(sink == nullptr)
+                return;
+
+            lifecycle_log_line line{sink};
+            format_event(line.str(), event, type.type_name());
+            line.str().push_back('\n');
+        }
+#endif
+    } // namespace QS_LIFECYCLE_ABI
+
+    template<class Logger, class = void>
+    struct is_default_logger : std::false_type
+    {};
+
+    template<class Logger>
+    struct is_default_logger<Logger, typename Logger::default_logger_tag> : std::true_type
+    {};
+
+    template<class Filter, class = void>
+    struct is_default_filter : std::false_type
+    {};
+
+    template<class Filter>
+    struct is_default_filter<Filter, typename Filter::default_filter_tag> : std::true_type
+    {};
+} // namespace intl
+
+
+// A construction stack shared by live instances, as reported by print_leaks()
+struct lifecycle_leak_stack
+{
+    size_t                   alive;
+    std::vector<std::string> frames;
+};
+
+// A copy site whose source objects were destroyed right after, as reported by print_missed_moves()
+struct lifecycle_missed_move
+{
+    size_t                   count;
+    lifecycle_event          event;
+    std::vector<std::string> frames;
+};
+
+// Events that involve a moved-from object, as reported by print_move_quality()
+struct lifecycle_move_quality
+{
+    size_t moves_from_moved;            // moves whose source was already moved from
+    size_t copy_assignments_into_moved; // copy assignments into a moved-from object
+    size_t moved_destructions;          // destructions of moved-from objects
+    size_t live_destructions;           // destructions of the other objects
+};
+
+
+namespace intl
+{
+    template<class Tracker, class T, size_t Uuid>
+    class lifecycle_tracker_common;
+
+    // Construction stack of fixed depth, interned by qs::intl::lifecycle_stack_table
+    struct lifecycle_stack
+    {
+        void*    frames[QS_LIFECYCLE_STACK_DEPTH];
+        unsigned size;
+
+        bool operator==(lifecycle_stack const& rhs) const noexcept
+        {
+            if(size != rhs.size)
+                return false;
+            for(unsigned i = 0; i < size; ++i)
+                if(frames[i] != rhs.frames[i])
+                    return false;
+            return true;
+        }
+    };
+
+    struct lifecycle_stack_hash
+    {
+        size_t operator()(lifecycle_stack const& stack) const noexcept
+        {
+            size_t h = stack.size;
+            for(unsigned i = 0; i < stack.size; ++i)
+                h ^= reinterpret_cast<std::uintptr_t>(stack.frames[i]) + 0x9e3779b9 + (h << 6) +
+                     (h >> 2);
+            return h;
+        }
+    };
+
+    // Capture the calling stack, dropping the innermost frames. Always inlined, so that
+    // the frame of the caller is the first one.
+    QS_ALWAYS_INLINE lifecycle_stack capture_stack(unsigned skip) noexcept
+    {
+        lifecycle_stack stack;
+        stack.size = 0;
+#if QS_LIFECYCLE_TRACKER_WITH_BACKTRACE
+        void*     frames[QS_LIFECYCLE_STACK_DEPTH + 4];
+        int const count = ::backtrace(frames, QS_LIFECYCLE_STACK_DEPTH + 4);
+        for(int i = static_cast<int>(skip); i < count && stack.size < QS_LIFECYCLE_STACK_DEPTH; ++i)
+            stack.frames[stack.size++] = frames[i];
+#else
+        ignore_unused(skip);
+#endif
+        return stack;
+    }
+
+    // Table of one feature for the tracker `Tracker`, allocated on first use and never
+    // destroyed, so that objects with static storage can still use it during exit
+    template<class Table, class Tracker>
+    Table& lifecycle_side_table()
+    {
+        static auto* const table = new Table{};
+        return *table;
+    }
+
+    // Process-wide set of interned construction stacks with cached symbolization.
+    // Id 0 is the empty stack, also used once QS_LIFECYCLE_STACK_CAPACITY stacks are interned.
+    class lifecycle_stack_table
+    {
+    public:
+        static lifecycle_stack_table& instance();
+
+        uint32_t intern(lifecycle_stack const& stack);
+
+        std::vector<std::string> symbolize(uint32_t id);
+
+    private:
+        struct state_t;
+        std::unique_ptr<state_t> state_;
+
+        lifecycle_stack_table();
+        ~lifecycle_stack_table();
+
+        // "module(mangled+0x1f) [0x...]" from backtrace_symbols, with the name demangled
+        static std::string symbolize_frame_(void* frame);
+    };
+
+    // Construction stacks of the live instances of one tracker, keyed by address
+    class lifecycle_instance_stacks
+    {
+    public:
+        lifecycle_instance_stacks();
+        ~lifecycle_instance_stacks();
+
+        void on_construct(void const* self, lifecycle_stack const& stack);
+        void on_destroy(void const* self);
+        void clear();
+        size_t size();
+        std::vector<lifecycle_leak_stack> leaks(size_t max_stacks);
+
+    private:
+        struct state_t;
+        std::unique_ptr<state_t> state_;
+    };
+
+    inline namespace QS_LIFECYCLE_ABI
+    {
+        // Write a leak report for one type to a sink
+        QS_LIFECYCLE_API void print_leak_report(lifecycle_sink* sink, std::string const& type_name,
+                                                size_t uuid, size_t alive,
+                                                std::vector<lifecycle_leak_stack> const& stacks)
+#if QS_LIFECYCLE_DECLARE_ONLY
+            ;
+#else
+        {
+            if(sink == nullptr)
+                return;
+            std::string out = "Lifecycle leaks [type: " + type_name +
+                              ", uuid: " + std::to_string(uuid) + "]: " + std::to_string(alive) +
+                              " alive\n";
+            for(lifecycle_leak_stack const& stack : stacks)
+            {
+                out += " * " + std::to_string(stack.alive) + " alive, constructed at:\n";
+                if(stack.frames.empty())
+                    out += "     <no stack>\n";
+                for(size_t i = 0; i < stack.frames.size(); ++i)
+                    out += "     #" + std::to_string(i) + " " + stack.frames[i] + "\n";
+            }
+            lifecycle_log_line line{sink, true};
+            line.str() += out;
+        }
+#endif
+    } // namespace QS_LIFECYCLE_ABI
+
+    // Copy sites of one tracker whose source was destroyed right after, counted per
+    // construction stack and event
+    class lifecycle_copy_sites
+    {
+    public:
+        lifecycle_copy_sites();
+        ~lifecycle_copy_sites();
+
+        void add(lifecycle_stack const& stack, lifecycle_event event);
+        void clear();
+        std::vector<lifecycle_missed_move> get(size_t max_sites, size_t& total);
+
+    private:
+        struct state_t;
+        std::unique_ptr<state_t> state_;
+    };
+
+    // Copies whose source is destroyed by the same thread within a few events of the type,
+    // reported as missed moves per copy site. Each thread keeps its recent copies in a ring.
+    template<class Tracker>
+    class lifecycle_missed_moves
+    {
+    public:
+        static void on_event() noexcept { ++local_().seq; }
+
+        static void on_copy(void const* source, lifecycle_event event, lifecycle_stack const& stack)
+        {
+            local_t& l    = local_();
+            copy_t&  slot = l.recent[l.next++ % QS_LIFECYCLE_MISSED_MOVE_WINDOW];
+            slot          = {source, l.seq, event, stack};
+        }
+
+        static void on_destroy(void const* self)
+        {
+            local_t& l = local_();
+            for(copy_t& copy : l.recent)
+            {
+                if(copy.source != self || l.seq - copy.seq > QS_LIFECYCLE_MISSED_MOVE_WINDOW)
+                    continue;
+                copy.source = nullptr;
+                sites_().add(copy.stack, copy.event);
+                return;
+            }
+        }
+
+        static void clear() { sites_().clear(); }
+
+        static std::vector<lifecycle_missed_move> sites(size_t max_sites, size_t& total)
+        {
+            return sites_().get(max_sites, total);
+        }
+
+    private:
+        struct copy_t
+        {
+            void const*     source;
+            size_t          seq;
+            lifecycle_event event;
+            lifecycle_stack stack;
+        };
+
+        struct local_t
+        {
+            copy_t recent[QS_LIFECYCLE_MISSED_MOVE_WINDOW];
+            size_t seq;
+            size_t next;
+        };
+
+        static local_t& local_() noexcept
+        {
+            thread_local local_t l{};
+            return l;
+        }
+
+        static lifecycle_copy_sites& sites_()
+        {
+            return lifecycle_side_table<lifecycle_copy_sites, Tracker>();
+        }
+    };
+
+    // Moved-from flag of every instance of one tracker, kept in a side table by address, and the
+    // counts of the events that involve a moved-from object. An assignment makes its target
+    // valid again.
+    class lifecycle_moved_from
+    {
+    public:
+        lifecycle_moved_from();
+        ~lifecycle_moved_from();
+
+        void on_event(lifecycle_event event, void const* self, void const* source);
+        void clear();
+        lifecycle_move_quality get();
+
+    private:
+        struct state_t;
+        std::unique_ptr<state_t> state_;
+    };
+
+    inline namespace QS_LIFECYCLE_ABI
+    {
+        // Write the missed moves of one type to a sink
+        QS_LIFECYCLE_API void print_missed_moves(lifecycle_sink* sink, std::string const& type_name,
+                                                 size_t uuid, size_t total,
+                                                 std::vector<lifecycle_missed_move> const& sites)
+#if QS_LIFECYCLE_DECLARE_ONLY
+            ;
+#else
+        {
+            if(sink == nullptr)
+                return;
+            std::string out = "Lifecycle missed moves [type: " + type_name +
+                              ", uuid: " + std::to_string(uuid) + "]: " + std::to_string(total) +
+                              "\n";
+            for(lifecycle_missed_move const& site : sites)
+            {
+                out += " * " + std::to_string(site.count) +
+                       (site.event == lifecycle_event::CopyConstructor ? " copy constructions"
+                                                                       : " copy assignments") +
+                       " from an object destroyed right after, at:\n";
+                if(site.frames.empty())
+                    out += "     <no stack>\n";
+                for(size_t i = 0; i < site.frames.size(); ++i)
+                    out += "     #" + std::to_string(i) + " " + site.frames[i] + "\n";
+            }
+            lifecycle_log_line line{sink, true};
+            line.str() += out;
+        }
+#endif
+
+        // Write the move quality of one type to a sink
+        QS_LIFECYCLE_API void print_move_quality(lifecycle_sink* sink, std::string const& type_name,
+                                                 size_t uuid, lifecycle_move_quality const& quality)
+#if QS_LIFECYCLE_DECLARE_ONLY
+            ;
+#else
+        {
+            if(sink == nullptr)
+                return;
+            std::string out = "Lifecycle move quality [type: " + type_name +
+                              ", uuid: " + std::to_string(uuid) + "]\n";
+            out += " * moves from a moved-from object            : " +
+                   std::to_string(quality.moves_from_moved) + "\n";
+            out += " * copy assignments into a moved-from object : " +
+                   std::to_string(quality.copy_assignments_into_moved) + "\n";
+            out += " * destructions (moved-from/live)            : " +
+                   std::to_string(quality.moved_destructions + quality.live_destructions) + " (" +
+                   std::to_string(quality.moved_destructions) + "/" +
+                   std::to_string(quality.live_destructions) + ")\n";
+            lifecycle_log_line line{sink, true};
+            line.str() += out;
+        }
+#endif
+    } // namespace QS_LIFECYCLE_ABI
+
+#if !QS_LIFECYCLE_DECLARE_ONLY
+    struct lifecycle_stack_table::state_t
+    {
+        std::mutex                                                          mutex;
+        std::vector<lifecycle_stack>                                        stacks;
+        std::unordered_map<lifecycle_stack, uint32_t, lifecycle_stack_hash> ids;
+        std::unordered_map<void*, std::string>                              symbols;
+    };
+
+    QS_LIFECYCLE_API lifecycle_stack_table& lifecycle_stack_table::instance()
+    {
+        static auto* const table = new lifecycle_stack_table{};
+        return *table;
+    }
+
+    QS_LIFECYCLE_API lifecycle_stack_table::lifecycle_stack_table()
+        : state_{new state_t{}}
+    {
+        lifecycle_stack empty;
+        empty.size = 0;
+        state_->stacks.push_back(empty);
+        state_->ids.emplace(empty, 0);
+    }
+
+    QS_LIFECYCLE_API lifecycle_stack_table::~lifecycle_stack_table() = default;
+
+    QS_LIFECYCLE_API uint32_t lifecycle_stack_table::intern(lifecycle_stack const& stack)
+    {
+        state_t&                    st = *state_;
+        std::lock_guard<std::mutex> lock{st.mutex};
+        auto const                  it = st.ids.find(stack);
+        if(it != st.ids.end())
+            return it->second;
+        if(st.stacks.size() >= QS_LIFECYCLE_STACK_CAPACITY)
+            return 0;
+        auto const id = static_cast<uint32_t>(st.stacks.size());
+        st.stacks.push_back(stack);
+        st.ids.emplace(stack, id);
+        return id;
+    }
+
+    QS_LIFECYCLE_API std::vector<std::string> lifecycle_stack_table::symbolize(uint32_t id)
+    {
+        state_t&                    st = *state_;
+        std::lock_guard<std::mutex> lock{st.mutex};
+        lifecycle_stack const&      stack = st.stacks[id];
+        std::vector<std::string>    res;
+        res.reserve(stack.size);
+        for(unsigned i = 0; i < stack.size; ++i)
+        {
+            auto it = st.symbols.find(stack.frames[i]);
+            if(it == st.symbols.end())
+                it = st.symbols.emplace(stack.frames[i], symbolize_frame_(stack.frames[i])).first;
+            res.push_back(it->second);
+        }
+        return res;
+    }
+
+    QS_LIFECYCLE_API std::string lifecycle_stack_table::symbolize_frame_(void* frame)
+    {
+#if QS_LIFECYCLE_TRACKER_WITH_BACKTRACE
+        std::unique_ptr<char*, void (*)(void*)> symbols{::backtrace_symbols(&frame, 1), std::free};
+        if(symbols == nullptr)
+            return "??";
+        std::string  line = symbols.get()[0];
+        size_t const open = line.find('(');
+        size_t const plus = line.find('+', open);
+        if(open == std::string::npos || plus == std::string::npos || plus == open + 1)
+            return line;
+        line.replace(open + 1, plus - open - 1,
+                     demangle(line.substr(open + 1, plus - open - 1).c_str()));
+        return line;
+#else
+        ignore_unused(frame);
+        return "??";
+#endif
+    }
+
+    struct lifecycle_instance_stacks::state_t
+    {
+        std::mutex                                mutex;
+        std::unordered_map<void const*, uint32_t> live;
+    };
+
+    QS_LIFECYCLE_API lifecycle_instance_stacks::lifecycle_instance_stacks()
+        : state_{new state_t{}}
+    {}
+
+    QS_LIFECYCLE_API lifecycle_instance_stacks::~lifecycle_instance_stacks() = default;
+
+    QS_LIFECYCLE_API void lifecycle_instance_stacks::on_construct(void const*            self,
+                                                                  lifecycle_stack const& stack)
+    {
+        uint32_t const              id = lifecycle_stack_table::instance().intern(stack);
+        std::lock_guard<std::mutex> lock{state_->mutex};
+        state_->live[self] = id;
+    }
+
+    QS_LIFECYCLE_API void lifecycle_instance_stacks::on_destroy(void const* self)
+    {
+        std::lock_guard<std::mutex> lock{state_->mutex};
+        state_->live.erase(self);
+    }
+
+    QS_LIFECYCLE_API void lifecycle_instance_stacks::clear()
+    {
+        std::lock_guard<std::mutex> lock{state_->mutex};
+        state_->live.clear();
+    }
+
+    QS_LIFECYCLE_API size_t lifecycle_instance_stacks::size()
+    {
+        std::lock_guard<std::mutex> lock{state_->mutex};
+        return state_->live.size();
+    }
+
+    QS_LIFECYCLE_API std::vector<lifecycle_leak_stack>
+    lifecycle_instance_stacks::leaks(size_t max_stacks)
+    {
+        std::unordered_map<uint32_t, size_t> counts;
+        {
+            std::lock_guard<std::mutex> lock{state_->mutex};
+            for(auto const& kv : state_->live)
+                ++counts[kv.second];
+        }
+
+        std::vector<std::pair<size_t, uint32_t>> sorted;
+        sorted.reserve(counts.size());
+        for(auto const& kv : counts)
+            sorted.emplace_back(kv.second, kv.first);
+        std::sort(sorted.begin(), sorted.end(),
+                  [](std::pair<size_t, uint32_t> const& a, std::pair<size_t, uint32_t> const& b)
+                  { return a.first != b.first ? a.first > b.first : a.second < b.second; });
+        if(sorted.size() > max_stacks)
+            sorted.resize(max_stacks);
+
+        std::vector<lifecycle_leak_stack> res;
+        res.reserve(sorted.size());
+        for(auto const& entry : sorted)
+            res.push_back({entry.first, lifecycle_stack_table::instance().symbolize(entry.second)});
+        return res;
+    }
+
+    struct lifecycle_copy_sites::state_t
+    {
+        std::mutex                           mutex;
+        std::unordered_map<uint64_t, size_t> sites;
+    };
+
+    QS_LIFECYCLE_API lifecycle_copy_sites::lifecycle_copy_sites()
+        : state_{new state_t{}}
+    {}
+
+    QS_LIFECYCLE_API lifecycle_copy_sites::~lifecycle_copy_sites() = default;
+
+    QS_LIFECYCLE_API void lifecycle_copy_sites::add(lifecycle_stack const& stack,
+                                                    lifecycle_event        event)
+    {
+        uint32_t const              id  = lifecycle_stack_table::instance().intern(stack);
+        uint64_t const              key = (uint64_t{id} << 8) | static_cast<uint64_t>(event);
+        std::lock_guard<std::mutex> lock{state_->mutex};
+        ++state_->sites[key];
+    }
+
+    QS_LIFECYCLE_API void lifecycle_copy_sites::clear()
+    {
+        std::lock_guard<std::mutex> lock{state_->mutex};
+        state_->sites.clear();
+    }
+
+    QS_LIFECYCLE_API std::vector<lifecycle_missed_move> lifecycle_copy_sites::get(size_t  max_sites,
+                                                                                  size_t& total)
+    {
+        std::vector<std::pair<size_t, uint64_t>> sorted;
+        {
+            std::lock_guard<std::mutex> lock{state_->mutex};
+            for(auto const& kv : state_->sites)
+                sorted.emplace_back(kv.second, kv.first);
+        }
+        std::sort(sorted.begin(), sorted.end(),
+                  [](std::pair<size_t, uint64_t> const& a, std::pair<size_t, uint64_t> const& b)
+                  { return a.first != b.first ? a.first > b.first : a.second < b.second; });
+        total = 0;
+        for(auto const& entry : sorted)
+            total += entry.first;
+        if(sorted.size() > max_sites)
+            sorted.resize(max_sites);
+
+        std::vector<lifecycle_missed_move> res;
+        res.reserve(sorted.size());
+        for(auto const& entry : sorted)
+            res.push_back({entry.first, static_cast<lifecycle_event>(entry.second & 0xff),
+                           lifecycle_stack_table::instance().symbolize(
+                               static_cast<uint32_t>(entry.second >> 8))});
+        return res;
+    }
+
+    struct lifecycle_moved_from::state_t
+    {
+        std::mutex                      mutex;
+        std::unordered_set<void const*> moved;
+        lifecycle_move_quality          quality;
+    };
+
+    QS_LIFECYCLE_API lifecycle_moved_from::lifecycle_moved_from()
+        : state_{new state_t{}}
+    {}
+
+    QS_LIFECYCLE_API lifecycle_moved_from::~lifecycle_moved_from() = default;
+
+    QS_LIFECYCLE_API void lifecycle_moved_from::on_event(lifecycle_event event, void const* self,
+                                                         void const* source)
+    {
+        state_t&                    st = *state_;
+        std::lock_guard<std::mutex> lock{st.mutex};
+        bool const                  was_moved = st.moved.erase(self) != 0;
+        if(event == lifecycle_event::Destructor)
+            ++(was_moved ? st.quality.moved_destructions : st.quality.live_destructions);
+        else if(event == lifecycle_event::CopyAssignment && was_moved)
+            ++st.quality.copy_assignments_into_moved;
+        else if(event == lifecycle_event::MoveConstructor ||
+                event == lifecycle_event::MoveAssignment)
+            if(!st.moved.insert(source).second)
+                ++st.quality.moves_from_moved;
+    }
+
+    QS_LIFECYCLE_API void lifecycle_moved_from::clear()
+    {
+        std::lock_guard<std::mutex> lock{state_->mutex};
+        state_->moved.clear();
+        state_->quality = {};
+    }
+
+    QS_LIFECYCLE_API lifecycle_move_quality lifecycle_moved_from::get()
+    {
+        std::lock_guard<std::mutex> lock{state_->mutex};
+        return state_->quality;
+    }
+#endif
+} // namespace intl
+
+
+// Leak reports of all the types with construction stacks enabled
+class lifecycle_leaks
+{
+public:
+    // Print the report of every type when the program exits
+    static void set_report_at_exit(bool enabled, size_t max_stacks = 10,
+                                   lifecycle_sink* sink = lifecycle_sinks::stderr_sink());
+
+    // Print the report of every type with construction stacks enabled
+    static void print_all(size_t          max_stacks = 10,
+                          lifecycle_sink* sink       = lifecycle_sinks::stderr_sink());
+
+private:
+    template<class, class, size_t>
+    friend class intl::lifecycle_tracker_common;
+
+    using reporter_t = void (*)(size_t, lifecycle_sink*);
+
+    struct state_t;
+
+    static state_t& state_();
+
+    static void register_type_(reporter_t report);
+
+    static void on_exit_();
+};
+
+#if !QS_LIFECYCLE_DECLARE_ONLY
+struct lifecycle_leaks::state_t
+{
+    std::mutex              mutex;
+    std::vector<reporter_t> reporters;
+    bool                    at_exit    = false;
+    bool                    registered = false;
+    size_t                  max_stacks = 10;
+    lifecycle_sink*         sink       = nullptr;
+};
+
+QS_LIFECYCLE_API lifecycle_leaks::state_t& lifecycle_leaks::state_()
+{
+    static auto* const st = new state_t{};
+    return *st;
+}
+
+QS_LIFECYCLE_API void lifecycle_leaks::set_report_at_exit(bool enabled, size_t max_stacks,
+                                                          lifecycle_sink* sink)
+{
+    state_t&                    st = state_();
+    std::lock_guard<std::mutex> lock{st.mutex};
+    st.at_exit    = enabled;
+    st.max_stacks = max_stacks;
+    st.sink       = sink;
+    if(enabled && !st.registered)
+        st.registered = std::atexit(&on_exit_) == 0;
+}
+
+QS_LIFECYCLE_API void lifecycle_leaks::print_all(size_t max_stacks, lifecycle_sink* sink)
+{
+    std::vector<reporter_t> reporters;
+    {
+        state_t&                    st = state_();
+        std::lock_guard<std::mutex> lock{st.mutex};
+        reporters = st.reporters;
+    }
+    for(reporter_t const report : reporters)
+        report(max_stacks, sink);
+}
+
+QS_LIFECYCLE_API void lifecycle_leaks::register_type_(reporter_t report)
+{
+    state_t&                    st = state_();
+    std::lock_guard<std::mutex> lock{st.mutex};
+    if(std::find(st.reporters.begin(), st.reporters.end(), report) == st.reporters.end())
+        st.reporters.push_back(report);
+}
+
+QS_LIFECYCLE_API void lifecycle_leaks::on_exit_()
+{
+    state_t& st = state_();
+    if(st.at_exit)
+        print_all(st.max_stacks, st.sink);
+}
+#endif
+
+
+// Time spent by the tracker itself on the events of a type, see set_overhead_timing_enabled()
+struct lifecycle_overhead
+{
+    size_t        events;      // events timed
+    std::uint64_t counting_ns; // counter updates, out of line while timing
+    std::uint64_t logging_ns;  // the logger and get_type_name(), with lifecycle_logger overrides
+    std::uint64_t features_ns; // the other enabled features and the subscribers
+
+    std::uint64_t total_ns() const noexcept { return counting_ns + logging_ns + features_ns; }
+
+    lifecycle_overhead& operator+=(lifecycle_overhead const& rhs) noexcept
+    {
+        events += rhs.events;
+        counting_ns += rhs.counting_ns;
+        logging_ns += rhs.logging_ns;
+        features_ns += rhs.features_ns;
+        return *this;
+    }
+};
+
+
+// Type-erased access to the counters of one tracked type
+struct lifecycle_type_entry
+{
+    std::string const& (*type_name)();
+    lifecycle_counters (*counters)();
+    size_t uuid;
+    bool   mt;
+    // Mangled name with static storage, readable where type_name() could allocate
+    char const* mangled_name = nullptr;
+    // Check the sink of the type again after the sinks are configured
+    void (*refresh_sink)() = nullptr;
+    // Time spent by the tracker on the events of the type
+    lifecycle_overhead (*overhead)() = nullptr;
+};
+
+
+namespace intl
+{
+    // Fixed-capacity storage of the registry. It is constant-initialized and never moves, so
+    // trackers can register during static initialization and readers need no lock.
+    template<class Dummy = void>
+    struct lifecycle_registry_storage
+    {
+        struct slot_t
+        {
+            lifecycle_type_entry entry;
+            std::atomic<bool>    ready;
+        };
+
+        QS_INLINE_VAR static slot_t slots[QS_LIFECYCLE_REGISTRY_CAPACITY] QS_INLINE_VAR_INIT({});
+        QS_INLINE_VAR static std::atomic<size_t> claimed QS_INLINE_VAR_INIT({});
+    };
+
+#if !defined(__cpp_inline_variables)
+    template<class Dummy>
+    typename lifecycle_registry_storage<Dummy>::slot_t
+        lifecycle_registry_storage<Dummy>::slots[QS_LIFECYCLE_REGISTRY_CAPACITY];
+    template<class Dummy>
+    std::atomic<size_t> lifecycle_registry_storage<Dummy>::claimed{};
+#endif
+
+    // Counters of every registered type in tables indexed by the registry id, allocated in
+    // chunks of rows as types register. A qs::lifecycle_tracker counts in a row of one cache
+    // line. A qs::lifecycle_tracker_mt counts in a row of six atomics, each on its own cache line
+    // so that threads counting different events do not share lines.
+    template<class Dummy = void>
+    struct lifecycle_counter_table
+    {
+        struct alignas(QS_CACHELINE_SIZE) row_t
+        {
+            lifecycle_counters counts;
+        };
+
+        struct alignas(QS_CACHELINE_SIZE) atomic_cell_t
+        {
+            std::atomic<size_t> value;
+        };
+
+        struct shared_row_t
+        {
+            atomic_cell_t cells[6];
+        };
+
+        static constexpr size_t chunk_rows = 64;
+        static constexpr size_t chunks =
+            (QS_LIFECYCLE_REGISTRY_CAPACITY + chunk_rows - 1) / chunk_rows;
+
+        QS_INLINE_VAR static std::atomic<row_t*> rows[chunks] QS_INLINE_VAR_INIT({});
+        QS_INLINE_VAR static std::atomic<shared_row_t*> shared_rows[chunks] QS_INLINE_VAR_INIT({});
+
+        // Start counting in the row of a type, from the counts it had before registering
+        static lifecycle_counters* place(size_t id, lifecycle_counters const& cnts)
+        {
+            row_t& row = chunk_(rows, id)[id % chunk_rows];
+            row.counts = cnts;
+            return &row.counts;
+        }
+
+        // Zeroed row of an mt type
+        static shared_row_t* place(size_t id)
+        {
+            return &chunk_(shared_rows, id)[id % chunk_rows];
+        }
+
+        // Relaxed loads of the six atomics of a row
+        static lifecycle_counters load(shared_row_t const& row) noexcept
+        {
+            return lifecycle_counters{row.cells[0].value.load(std::memory_order_relaxed),
+                                      row.cells[1].value.load(std::memory_order_relaxed),
+                                      row.cells[2].value.load(std::memory_order_relaxed),
+                                      row.cells[3].value.load(std::memory_order_relaxed),
+                                      row.cells[4].value.load(std::memory_order_relaxed),
+                                      row.cells[5].value.load(std::memory_order_relaxed)};
+        }
+
+        // Copy the row of a type, zero if its chunk is not allocated yet
+        static lifecycle_counters load(size_t id, bool mt) noexcept
+        {
+            size_t const chunk = id / chunk_rows;
+            if(mt)
+            {
+                shared_row_t const* const row = shared_rows[chunk].load(std::memory_order_acquire);
+                return row != nullptr ? load(row[id % chunk_rows]) : lifecycle_counters{};
+            }
+            row_t const* const row = rows[chunk].load(std::memory_order_acquire);
+            return row != nullptr ? row[id % chunk_rows].counts : lifecycle_counters{};
+        }
+
+    private:
+        // Chunk of the row of a type, allocated by the first type registering in it. A type
+        // losing the race for an empty chunk frees its own allocation.
+        template<class Row>
+        static Row* chunk_(std::atomic<Row*> (&table)[chunks], size_t id)
+        {
+            std::atomic<Row*>& slot  = table[id / chunk_rows];
+            Row*               chunk = slot.load(std::memory_order_acquire);
+            if(chunk != nullptr)
+                return chunk;
+            void*      raw   = nullptr;
+            Row* const fresh = allocate_<Row>(raw);
+            if(slot.compare_exchange_strong(chunk, fresh, std::memory_order_acq_rel))
+                return fresh;
+            ::operator delete(raw);
+            return chunk;
+        }
+
+        // Zeroed rows aligned to a cache line, never freed once published. `raw` receives the
+        // allocation to free instead.
+        template<class Row>
+        static Row* allocate_(void*& raw)
+        {
+            size_t space = sizeof(Row) * chunk_rows + alignof(Row);
+            raw          = ::operator new(space);
+            void* start  = raw;
+            Row* const chunk =
+                static_cast<Row*>(std::align(alignof(Row), sizeof(Row) * chunk_rows, start, space));
+            for(size_t i = 0; i < chunk_rows; ++i)
+                ::new(static_cast<void*>(chunk + i)) Row{};
+            return chunk;
+        }
+    };
+
+#if !defined(__cpp_inline_variables)
+    template<class Dummy>
+    constexpr size_t lifecycle_counter_table<Dummy>::chunk_rows;
+    template<class Dummy>
+    constexpr size_t lifecycle_counter_table<Dummy>::chunks;
+    template<class Dummy>
+    std::atomic<typename lifecycle_counter_table<Dummy>::row_t*>
+        lifecycle_counter_table<Dummy>::rows[chunks];
+    template<class Dummy>
+    std::atomic<typename lifecycle_counter_table<Dummy>::shared_row_t*>
+        lifecycle_counter_table<Dummy>::shared_rows[chunks];
+#endif
+
+#if !QS_LIFECYCLE_DECLARE_ONLY
+    // Append a JSON string literal
+    inline void append_json_string(std::string& out, std::string const& str)
+    {
+        out.push_back('"');
+        for(char const c : str)
+        {
+            if(c == '"' || c == '\\')
+            {
+                out.push_back('\\');
+                out.push_back(c);
+            }
+            else if(static_cast<unsigned char>(c) < 0x20)
+            {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+                out += escaped;
+            }
+            else
+                out.push_back(c);
+        }
+        out.push_back('"');
+    }
+#endif
+} // namespace intl
+
+
+// Registry of every tracked type, in registration order. A type registers during static
+// initialization when its tracker is used anywhere in the program, and its index is its id.
+class lifecycle_registry
+{
+    using storage = intl::lifecycle_registry_storage<>;
+
+public:
+    // Number of registered types, some of which may still be registering
+    static size_t size() noexcept
+    {
+        size_t const claimed = storage::claimed.load(std::memory_order_acquire);
+        return claimed < QS_LIFECYCLE_REGISTRY_CAPACITY ? claimed
+                                                        : size_t{QS_LIFECYCLE_REGISTRY_CAPACITY};
+    }
+
+    // Entry of a type, or nullptr while it is registering
+    static lifecycle_type_entry const* get(size_t id) noexcept
+    {
+        if(id >= size() || !storage::slots[id].ready.load(std::memory_order_acquire))
+            return nullptr;
+        return &storage::slots[id].entry;
+    }
+
+    // Counters of every registered type indexed by id, read row by row from one contiguous
+    // table. Types still registering read as zero. Reuses the capacity of out.
+    static void snapshot(std::vector<lifecycle_counters>& out);
+
+    static std::vector<lifecycle_counters> snapshot();
+
+    // Sum of the counters of every registered type
+    static lifecycle_counters total();
+
+    // Sum of a snapshot, in independent lanes per counter that the compiler can vectorize
+    static lifecycle_counters sum(std::vector<lifecycle_counters> const& cnts) noexcept
+    {
+        size_t lanes[6] = {};
+        for(lifecycle_counters const& c : cnts)
+        {
+            lanes[0] += c.constructor;
+            lanes[1] += c.copy_constructor;
+            lanes[2] += c.move_constructor;
+            lanes[3] += c.copy_assignment;
+            lanes[4] += c.move_assignment;
+            lanes[5] += c.destructor;
+        }
+        return lifecycle_counters{lanes[0], lanes[1], lanes[2], lanes[3], lanes[4], lanes[5]};
+    }
+
+    // Counters of every registered type as JSON, sorted by name, uuid and kind of tracker
+    static std::string to_json();
+
+    // Write to_json() to a file, returning false if it cannot be written
+    static bool write_json(char const* path);
+
+    // Register a type and get its id, or QS_LIFECYCLE_REGISTRY_CAPACITY if the registry is full
+    static size_t add(lifecycle_type_entry const& entry) noexcept
+    {
+        size_t const id = storage::claimed.fetch_add(1, std::memory_order_acq_rel);
+        if(id >= QS_LIFECYCLE_REGISTRY_CAPACITY)
+            return QS_LIFECYCLE_REGISTRY_CAPACITY;
+        storage::slots[id].entry = entry;
+        storage::slots[id].ready.store(true, std::memory_order_release);
+        if(id == 0)
+            std::atexit(&dump_at_exit_);
+        return id;
+    }
+
+private:
+    // Write the counters to the file named by QS_LIFECYCLE_DUMP, if set
+    static void dump_at_exit_();
+};
+
+#if !QS_LIFECYCLE_DECLARE_ONLY
+QS_LIFECYCLE_API void lifecycle_registry::snapshot(std::vector<lifecycle_counters>& out)
+{
+    size_t const n = size();
+    out.resize(n);
+    for(size_t id = 0; id < n; ++id)
+    {
+        if(lifecycle_type_entry const* const entry = get(id))
+            out[id] = intl::lifecycle_counter_table<>::load(id, entry->mt);
+        else
+            out[id] = lifecycle_counters{};
+    }
+}
+
+QS_LIFECYCLE_API std::vector<lifecycle_counters> lifecycle_registry::snapshot()
+{
+    std::vector<lifecycle_counters> out;
+    snapshot(out);
+    return out;
+}
+
+QS_LIFECYCLE_API lifecycle_counters lifecycle_registry::total()
+{
+    return sum(snapshot());
+}
+
+QS_LIFECYCLE_API std::string lifecycle_registry::to_json()
+{
+    std::vector<lifecycle_type_entry const*> entries;
+    for(size_t id = 0; id < size(); ++id)
+        if(lifecycle_type_entry const* const entry = get(id))
+            entries.push_back(entry);
+    std::sort(entries.begin(), entries.end(),
+              [](lifecycle_type_entry const* a, lifecycle_type_entry const* b)
+              {
+                  int const cmp = a->type_name().compare(b->type_name());
+                  if(cmp != 0)
+                      return cmp < 0;
+                  return a->uuid != b->uuid ? a->uuid < b->uuid : a->mt < b->mt;
+              });
+
+    std::string out = "{\n  \"version\": 1,\n  \"types\": [";
+    for(size_t i = 0; i < entries.size(); ++i)
+    {
+        lifecycle_counters const cnts = entries[i]->counters();
+        out += i == 0 ? "\n    {\"name\": " : ",\n    {\"name\": ";
+        intl::append_json_string(out, entries[i]->type_name());
+        out += ", \"uuid\": " + std::to_string(entries[i]->uuid);
+        out += entries[i]->mt ? ", \"mt\": true" : ", \"mt\": false";
+        out += ", \"constructor\": " + std::to_string(cnts.constructor);
+        out += ", \"copy_constructor\": " + std::to_string(cnts.copy_constructor);
+        out += ", \"move_constructor\": " + std::to_string(cnts.move_constructor);
+        out += ", \"copy_assignment\": " + std::to_string(cnts.copy_assignment);
+        out += ", \"move_assignment\": " + std::to_string(cnts.move_assignment);
+        out += ", \"destructor\": " + std::to_string(cnts.destructor);
+        out += ", \"alive\": " + std::to_string(cnts.alive()) + "}";
+    }
+    out += entries.empty() ? "]\n}\n" : "\n  ]\n}\n";
+    return out;
+}
+
+QS_LIFECYCLE_API bool lifecycle_registry::write_json(char const* path)
+{
+    std::FILE* const file = std::fopen(path, "w");
+    if(file == nullptr)
+        return false;
+    std::string const json = to_json();
+    bool const        ok   = std::fwrite(json.data(), 1, json.size(), file) == json.size();
+    return std::fclose(file) == 0 && ok;
+}
+
+QS_LIFECYCLE_API void lifecycle_registry::dump_at_exit_()
+{
+    if(char const* const path = std::getenv(QS_LIFECYCLE_DUMP_ENV))
+        if(!write_json(path))
+            std::fprintf(stderr, "lifecycle_tracker: cannot write %s\n", path);
+}
+#endif
+
+
+namespace intl
+{
+    template<class Dummy>
+    void lifecycle_sink_refresh<Dummy>::all()
+    {
+        for(size_t id = 0; id < lifecycle_registry::size(); ++id)
+            if(lifecycle_type_entry const* const entry = lifecycle_registry::get(id))
+                if(entry->refresh_sink != nullptr)
+                    entry->refresh_sink();
+    }
+} // namespace intl
+
+
+#if QS_LIFECYCLE_TRACKER_WITH_SIGNAL_DUMP
+// Dump of the counters of every registered type that is safe to take in a signal handler, to
+// look into a hung or overloaded process:
+//
+//     qs::lifecycle_signal_dump::install(SIGUSR1, fd);
+//
+// It writes the JSON of qs::lifecycle_registry::to_json() in registration order, with mangled
+// type names, as the names set at runtime can be allocating or changing at that point
+class lifecycle_signal_dump
+{
+public:
+    // Write the counters to a file descriptor. It only reads the registry and the counters and
+    // calls write(2), so it is async-signal-safe.
+    static bool write(int fd) noexcept;
+
+    // Call write(fd) whenever signo is received, returning false if sigaction fails. The
+    // defaults are SIGUSR1 and stderr.
+    static bool install() noexcept;
+    static bool install(int signo) noexcept;
+    static bool install(int signo, int fd) noexcept;
+
+    // Restore the default action of signo, SIGUSR1 by default
+    static bool uninstall() noexcept;
+    static bool uninstall(int signo) noexcept;
+
+private:
+    static std::atomic<int>& fd_() noexcept;
+
+    static void handle_(int) noexcept;
+};
+
+#if !QS_LIFECYCLE_DECLARE_ONLY
+namespace intl
+{
+    // Formats into a stack buffer and writes it with write(2), without allocating or locking
+    class signal_safe_writer
+    {
+    public:
+        explicit signal_safe_writer(int fd) noexcept
+            : fd_(fd)
+        {}
+
+        void str(char const* s) noexcept
+        {
+            while(*s != '\0')
+                put_(*s++);
+        }
+
+        // A string inside JSON quotes
+        void quoted(char const* s) noexcept
+        {
+            put_('"');
+            for(; *s != '\0'; ++s)
+            {
+                if(*s == '"' || *s == '\\')
+                    put_('\\');
+                put_(static_cast<unsigned char>(*s) < 0x20 ? '?' : *s);
+            }
+            put_('"');
+        }
+
+        void number(size_t value) noexcept
+        {
+            char   digits[20];
+            size_t n = 0;
+            do
+            {
+                digits[n++] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            } while(value != 0);
+            while(n != 0)
+                put_(digits[--n]);
+        }
+
+        // A signed number, such as alive() after reset_counters() with live objects
+        void number(ptrdiff_t value) noexcept
+        {
+            if(value < 0)
+                put_('-');
+            // the magnitude, also for the most negative value
+            number(value < 0 ? size_t{0} - static_cast<size_t>(value) : static_cast<size_t>(value));
+        }
+
+        // Write the buffered bytes, retrying partial and interrupted writes
+        bool flush() noexcept
+        {
+            for(size_t done = 0; done < size_;)
+            {
+                ssize_t const n = ::write(fd_, buffer_ + done, size_ - done);
+                if(n < 0 && errno == EINTR)
+                    continue;
+                if(n <= 0)
+                {
+                    ok_ = false;
+                    break;
+                }
+                done += static_cast<size_t>(n);
+            }
+            size_ = 0;
+            return ok_;
+        }
+
+    private:
+        void put_(char c) noexcept
+        {
+            if(size_ == sizeof(buffer_))
+                flush();
+            buffer_[size_++] = c;
+        }
+
+        int    fd_;
+        bool   ok_   = true;
+        size_t size_ = 0;
+        char   buffer_[512];
+    };
+} // namespace intl
+
+QS_LIFECYCLE_API bool lifecycle_signal_dump::write(int fd) noexcept
+{
+    intl::signal_safe_writer out{fd};
+    out.str("{\n  \"version\": 1,\n  \"mangled\": true,\n  \"types\": [");
+    bool first = true;
+    for(size_t id = 0; id < lifecycle_registry::size(); ++id)
+    {
+        lifecycle_type_entry const* const entry = lifecycle_registry::get(id);
+        if(entry == nullptr)
+            continue;
+        lifecycle_counters const cnts = entry->counters();
+        out.str(first ? "\n    {\"name\": " : ",\n    {\"name\": ");
+        out.quoted(entry->mangled_name != nullptr ? entry->mangled_name : "?");
+        out.str(", \"uuid\": ");
+        out.number(entry->uuid);
+        out.str(entry->mt ? ", \"mt\": true" : ", \"mt\": false");
+        out.str(", \"constructor\": ");
+        out.number(cnts.constructor);
+        out.str(", \"copy_constructor\": ");
+        out.number(cnts.copy_constructor);
+        out.str(", \"move_constructor\": ");
+        out.number(cnts.move_constructor);
+        out.str(", \"copy_assignment\": ");
+        out.number(cnts.copy_assignment);
+        out.str(", \"move_assignment\": ");
+        out.number(cnts.move_assignment);
+        out.str(", \"destructor\": ");
+        out.number(cnts.destructor);
+        out.str(", \"alive\": ");
+        out.number(cnts.alive());
+        out.str("}");
+        first = false;
+    }
+    out.str(first ? "]\n}\n" : "\n  ]\n}\n");
+    return out.flush();
+}
+
+QS_LIFECYCLE_API bool lifecycle_signal_dump::install() noexcept
+{
+    return install(SIGUSR1, STDERR_FILENO);
+}
+
+QS_LIFECYCLE_API bool lifecycle_signal_dump::install(int signo) noexcept
+{
+    return install(signo, STDERR_FILENO);
+}
+
+QS_LIFECYCLE_API bool lifecycle_signal_dump::install(int signo, int fd) noexcept
+{
+    fd_().store(fd, std::memory_order_relaxed);
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_handler = &handle_;
+    action.sa_flags   = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    return ::sigaction(signo, &action, nullptr) == 0;
+}
+
+QS_LIFECYCLE_API bool lifecycle_signal_dump::uninstall() noexcept
+{
+    return uninstall(SIGUSR1);
+}
+
+QS_LIFECYCLE_API bool lifecycle_signal_dump::uninstall(int signo) noexcept
+{
+    return ::signal(signo, SIG_DFL) != SIG_ERR;
+}
+
+QS_LIFECYCLE_API std::atomic<int>& lifecycle_signal_dump::fd_() noexcept
+{
+    static std::atomic<int> fd{STDERR_FILENO};
+    return fd;
+}
+
+QS_LIFECYCLE_API void lifecycle_signal_dump::handle_(int) noexcept
+{
+    int const saved = errno;
+    write(fd_().load(std::memory_order_relaxed));
+    errno = saved;
+}
+#endif
+#endif
+
+// Counters of the events that happened on one thread
+struct lifecycle_thread_counters
+{
+    std::string        thread;
+    lifecycle_counters counters;
+};
+
+// Number of objects constructed on one thread and destroyed on another
+struct lifecycle_thread_pair
+{
+    std::string creator;
+    std::string destroyer;
+    size_t      count;
+};
+
+
+namespace intl
+{
+    // Index of the calling thread in the per-thread reports. Indices are never reused, and
+    // their names are kept after the thread exits so that reports can still refer to it.
+    class lifecycle_thread_tag
+    {
+    public:
+        static size_t local()
+        {
+            thread_local size_t const index = register_();
+            return index;
+        }
+
+        static std::string name(size_t index);
+
+        static void set_name(size_t index, std::string name);
+
+    private:
+        struct state_t;
+
+        static state_t& state_();
+
+        static size_t register_();
+    };
+
+    // Counters of one thread in a qs::intl::lifecycle_thread_breakdown
+    struct lifecycle_thread_record
+    {
+        std::atomic<size_t> counts[6]; // written by the owning thread only
+        size_t              base[6];   // counts at the last reset, guarded by the records' mutex
+        size_t              thread;
+
+        lifecycle_counters load() const noexcept
+        {
+            return {counts[0].load(std::memory_order_relaxed) - base[0],
+                    counts[1].load(std::memory_order_relaxed) - base[1],
+                    counts[2].load(std::memory_order_relaxed) - base[2],
+                    counts[3].load(std::memory_order_relaxed) - base[3],
+                    counts[4].load(std::memory_order_relaxed) - base[4],
+                    counts[5].load(std::memory_order_relaxed) - base[5]};
+        }
+    };
+
+    // Records of the live threads of one tracked type, and the retired bucket
+    class lifecycle_thread_records
+    {
+    public:
+        lifecycle_thread_records();
+        ~lifecycle_thread_records();
+
+        // New record of the calling thread
+        lifecycle_thread_record* add();
+
+        // Fold a record into the retired bucket and free it
+        void retire(lifecycle_thread_record* rec);
+
+        // Count an event of a thread whose record is gone in the retired bucket
+        void retire_event(size_t event) noexcept;
+
+        std::vector<lifecycle_thread_counters> get();
+
+        void clear();
+
+    private:
+        struct state_t;
+        std::unique_ptr<state_t> state_;
+    };
+
+    // Per-thread counters of one tracked type. Each thread only writes its own record, so
+    // counting needs no read-modify-write, and a reset moves the baseline of the record instead
+    // of writing its counts. Records of exiting threads go to a retired bucket, which also takes
+    // the events of a thread after its record is gone.
+    template<class Tracker>
+    class lifecycle_thread_breakdown
+    {
+    public:
+        template<lifecycle_event Cnt>
+        static void increment() noexcept
+        {
+            lifecycle_thread_record* const rec = local_();
+            if(QS_UNLIKELY(rec == nullptr))
+                return retire_(static_cast<size_t>(Cnt));
+            std::atomic<size_t>& cnt = rec->counts[static_cast<size_t>(Cnt)];
+            cnt.store(cnt.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+
+        static std::vector<lifecycle_thread_counters> get() { return records_().get(); }
+
+        static void clear() { records_().clear(); }
+
+    private:
+        // Folds the record of the thread into the retired bucket when the thread exits
+        struct handle_t
+        {
+            lifecycle_thread_record* rec;
+            bool&                    exited;
+
+            explicit handle_t(bool& exited)
+                : rec{records_().add()}, exited(exited)
+            {}
+
+            ~handle_t()
+            {
+                records_().retire(rec);
+                exited = true;
+            }
+
+            handle_t(handle_t const&)            = delete;
+            handle_t& operator=(handle_t const&) = delete;
+        };
+
+        static lifecycle_thread_records& records_()
+        {
+            return lifecycle_side_table<lifecycle_thread_records, Tracker>();
+        }
+
+        // Record of the calling thread, or nullptr once its handle was destroyed at thread exit,
+        // so that a later event does not create a record that is never retired
+        static lifecycle_thread_record* local_()
+        {
+            thread_local bool exited = false; // trivially destructible, outlives the handle
+            if(exited)
+                return nullptr;
+            thread_local handle_t handle{exited};
+            return handle.rec;
+        }
+
+        QS_COLD QS_NOINLINE static void retire_(size_t event) noexcept
+        {
+            records_().retire_event(event);
+        }
+    };
+
+    // Creating thread of every live instance of one tracked type, and the number of
+    // destructions per creator and destroyer thread when the two differ
+    class lifecycle_instance_threads
+    {
+    public:
+        lifecycle_instance_threads();
+        ~lifecycle_instance_threads();
+
+        void on_construct(void const* self);
+        void on_destroy(void const* self);
+        void clear();
+        std::vector<lifecycle_thread_pair> pairs();
+
+    private:
+        struct state_t;
+        std::unique_ptr<state_t> state_;
+    };
+
+    inline namespace QS_LIFECYCLE_ABI
+    {
+        // Write the cross-thread destructions of one type to a sink
+        QS_LIFECYCLE_API void print_thread_pairs(lifecycle_sink* sink, std::string const& type_name,
+                                                 size_t                                    uuid,
+                                                 std::vector<lifecycle_thread_pair> const& pairs)
+#if QS_LIFECYCLE_DECLARE_ONLY
+            ;
+#else
+        {
+            if(sink == nullptr)
+                return;
+            size_t total = 0;
+            for(lifecycle_thread_pair const& pair : pairs)
+                total += pair.count;
+            std::string out = "Lifecycle cross-thread destructions [type: " + type_name +
+                              ", uuid: " + std::to_string(uuid) + "]: " + std::to_string(total) +
+                              "\n";
+            for(lifecycle_thread_pair const& pair : pairs)
+                out += " * " + pair.creator + " -> " + pair.destroyer + " : " +
+                       std::to_string(pair.count) + "\n";
+            lifecycle_log_line line{sink, true};
+            line.str() += out;
+        }
+#endif
+    } // namespace QS_LIFECYCLE_ABI
+
+#if !QS_LIFECYCLE_DECLARE_ONLY
+    struct lifecycle_thread_tag::state_t
+    {
+        std::mutex               mutex;
+        std::vector<std::string> names;
+    };
+
+    QS_LIFECYCLE_API lifecycle_thread_tag::state_t& lifecycle_thread_tag::state_()
+    {
+        static auto* const st = new state_t{};
+        return *st;
+    }
+
+    QS_LIFECYCLE_API std::string lifecycle_thread_tag::name(size_t index)
+    {
+        state_t&                    st = state_();
+        std::lock_guard<std::mutex> lock{st.mutex};
+        return st.names[index];
+    }
+
+    QS_LIFECYCLE_API void lifecycle_thread_tag::set_name(size_t index, std::string name)
+    {
+        state_t&                    st = state_();
+        std::lock_guard<std::mutex> lock{st.mutex};
+        st.names[index] = std::move(name);
+    }
+
+    QS_LIFECYCLE_API size_t lifecycle_thread_tag::register_()
+    {
+        state_t&                    st = state_();
+        std::lock_guard<std::mutex> lock{st.mutex};
+        st.names.push_back("thread-" + std::to_string(st.names.size() + 1));
+        return st.names.size() - 1;
+    }
+
+    struct lifecycle_thread_records::state_t
+    {
+        std::mutex                            mutex;
+        std::vector<lifecycle_thread_record*> live;
+        lifecycle_counters                    retired{};
+    };
+
+    QS_LIFECYCLE_API lifecycle_thread_records::lifecycle_thread_records()
+        : state_{new state_t{}}
+    {}
+
+    QS_LIFECYCLE_API lifecycle_thread_records::~lifecycle_thread_records() = default;
+
+    QS_LIFECYCLE_API lifecycle_thread_record* lifecycle_thread_records::add()
+    {
+        auto* const rec = new lifecycle_thread_record{{}, {}, lifecycle_thread_tag::local()};
+        std::lock_guard<std::mutex> lock{state_->mutex};
+        state_->live.push_back(rec);
+        return rec;
+    }
+
+    QS_LIFECYCLE_API void lifecycle_thread_records::retire(lifecycle_thread_record* rec)
+    {
+        state_t&                    st = *state_;
+        std::lock_guard<std::mutex> lock{st.mutex};
+        lifecycle_counters const    cnts = rec->load();
+        st.retired.constructor += cnts.constructor;
+        st.retired.copy_constructor += cnts.copy_constructor;
+        st.retired.move_constructor += cnts.move_constructor;
+        st.retired.copy_assignment += cnts.copy_assignment;
+        st.retired.move_assignment += cnts.move_assignment;
+        st.retired.destructor += cnts.destructor;
+        st.live.erase(std::find(st.live.begin(), st.live.end(), rec));
+        delete rec;
+    }
+
+    QS_LIFECYCLE_API void lifecycle_thread_records::retire_event(size_t event) noexcept
+    {
+        state_t&                    st = *state_;
+        std::lock_guard<std::mutex> lock{st.mutex};
+        size_t* const               counts[6] = {&st.retired.constructor,
+                                                 &st.retired.copy_constructor,
+                                                 &st.retired.move_constructor,
+                                                 &st.retired.copy_assignment,
+                                                 &st.retired.move_assignment,
+                                                 &st.retired.destructor};
+        ++*counts[event];
+    }
+
+    QS_LIFECYCLE_API std::vector<lifecycle_thread_counters> lifecycle_thread_records::get()
+    {
+        std::vector<lifecycle_thread_counters> res;
+        std::lock_guard<std::mutex>            lock{state_->mutex};
+        for(lifecycle_thread_record const* rec : state_->live)
+            res.push_back({lifecycle_thread_tag::name(rec->thread), rec->load()});
+        res.push_back({"retired", state_->retired});
+        return res;
+    }
+
+    QS_LIFECYCLE_API void lifecycle_thread_records::clear()
+    {
+        std::lock_guard<std::mutex> lock{state_->mutex};
+        for(lifecycle_thread_record* rec : state_->live)
+            for(size_t i = 0; i < 6; ++i)
+                rec->base[i] = rec->counts[i].load(std::memory_order_relaxed);
+        state_->retired = lifecycle_counters{};
+    }
+
+    struct lifecycle_instance_threads::state_t
+    {
+        std::mutex                                  mutex;
+        std::unordered_map<void const*, size_t>     live;
+        std::map<std::pair<size_t, size_t>, size_t> pairs;
+    };
+
+    QS_LIFECYCLE_API lifecycle_instance_threads::lifecycle_instance_threads()
+        : state_{new state_t{}}
+    {}
+
+    QS_LIFECYCLE_API lifecycle_instance_threads::~lifecycle_instance_threads() = default;
+
+    QS_LIFECYCLE_API void lifecycle_instance_threads::on_construct(void const* self)
+    {
+        size_t const                thread = lifecycle_thread_tag::local();
+        std::lock_guard<std::mutex> lock{state_->mutex};
+        state_->live[self] = thread;
+    }
+
+    QS_LIFECYCLE_API void lifecycle_instance_threads::on_destroy(void const* self)
+    {
+        size_t const                thread = lifecycle_thread_tag::local();
+        state_t&                    st     = *state_;
+        std::lock_guard<std::mutex> lock{st.mutex};
+        auto const                  it = st.live.find(self);
+        if(it == st.live.end())
+            return;
+        if(it->second != thread)
+            ++st.pairs[{it->second, thread}];
+        st.live.erase(it);
+    }
+
+    QS_LIFECYCLE_API void lifecycle_instance_threads::clear()
+    {
+        std::lock_guard<std::mutex> lock{state_->mutex};
+        state_->live.clear();
+        state_->pairs.clear();
+    }
+
+    QS_LIFECYCLE_API std::vector<lifecycle_thread_pair> lifecycle_instance_threads::pairs()
+    {
+        std::vector<lifecycle_thread_pair> res;
+        {
+            std::lock_guard<std::mutex> lock{state_->mutex};
+            for(auto const& kv : state_->pairs)
+                res.push_back({lifecycle_thread_tag::name(kv.first.first),
+                               lifecycle_thread_tag::name(kv.first.second), kv.second});
+        }
+        std::stable_sort(res.begin(), res.end(),
+                         [](lifecycle_thread_pair const& a, lifecycle_thread_pair const& b)
+                         { return a.count > b.count; });
+        return res;
+    }
+#endif
+} // namespace intl
+
+
+// Names of the threads in the per-thread counters of qs::lifecycle_tracker_mt
+class lifecycle_threads
+{
+public:
+    // Name the calling thread, "thread-<n>" by default
+    static void set_name(std::string name)
+    {
+        intl::lifecycle_thread_tag::set_name(intl::lifecycle_thread_tag::local(), std::move(name));
+    }
+
+    // Get the name of the calling thread
+    static std::string get_name()
+    {
+        return intl::lifecycle_thread_tag::name(intl::lifecycle_thread_tag::local());
+    }
+};
+
+
+// Counters of the events that happened while a kind of task was current
+struct lifecycle_task_counters
+{
+    std::string        task;
+    size_t             runs; // number of lifecycle_task_context::start(task) calls
+    lifecycle_counters counters;
+};
+
+
+namespace intl
+{
+    // Interned task names. Id 0 is the absence of a task, and ids are never reused, so that
+    // the per-type tables can be indexed without a lock.
+    class lifecycle_task_table
+    {
+    public:
+        // Id of the task `name`, or 0 when the table is full
+        static size_t intern(std::string const& name);
+
+        static std::string name(size_t id);
+
+        // Number of interned ids, including 0
+        static size_t size();
+
+        static std::atomic<size_t>& runs(size_t id) noexcept;
+
+        // Task of the calling thread
+        static size_t& current() noexcept
+        {
+            thread_local size_t id = 0;
+            return id;
+        }
+
+    private:
+        struct state_t;
+
+        static state_t& state_();
+    };
+
+#if !QS_LIFECYCLE_DECLARE_ONLY
+    struct lifecycle_task_table::state_t
+    {
+        std::mutex                    mutex;
+        std::vector<std::string>      names{std::string{}};
+        std::map<std::string, size_t> ids;
+        std::atomic<size_t>           runs[QS_LIFECYCLE_TASK_CAPACITY];
+    };
+
+    QS_LIFECYCLE_API lifecycle_task_table::state_t& lifecycle_task_table::state_()
+    {
+        static auto* const st = new state_t{};
+        return *st;
+    }
+
+    QS_LIFECYCLE_API size_t lifecycle_task_table::intern(std::string const& name)
+    {
+        state_t&                    st = state_();
+        std::lock_guard<std::mutex> lock{st.mutex};
+        auto const                  it = st.ids.find(name);
+        if(it != st.ids.end())
+            return it->second;
+        if(st.names.size() >= QS_LIFECYCLE_TASK_CAPACITY)
+            return 0;
+        st.names.push_back(name);
+        return st.ids[name] = st.names.size() - 1;
+    }
+
+    QS_LIFECYCLE_API std::string lifecycle_task_table::name(size_t id)
+    {
+        state_t&                    st = state_();
+        std::lock_guard<std::mutex> lock{st.mutex};
+        return st.names[id];
+    }
+
+    QS_LIFECYCLE_API size_t lifecycle_task_table::size()
+    {
+        state_t&                    st = state_();
+        std::lock_guard<std::mutex> lock{st.mutex};
+        return st.names.size();
+    }
+
+    QS_LIFECYCLE_API std::atomic<size_t>& lifecycle_task_table::runs(size_t id) noexcept
+    {
+        return state_().runs[id];
+    }
+#endif
+
+    // Per-task counters of one tracked type, allocated when first enabled and never freed, so
+    // that counting only needs an acquire load of the table
+    template<class Tracker>
+    class lifecycle_task_breakdown
+    {
+        struct table_t
+        {
+            std::atomic<size_t> counts[QS_LIFECYCLE_TASK_CAPACITY][6];
+        };
+
+    public:
+        // A thread losing the race to allocate the table frees its own
+        static void allocate()
+        {
+            if(table_.load(std::memory_order_acquire) != nullptr)
+                return;
+            table_t*       expected = nullptr;
+            table_t* const table    = new table_t{};
+            if(!table_.compare_exchange_strong(expected, table, std::memory_order_acq_rel))
+                delete table;
+        }
+
+        template<lifecycle_event Cnt>
+        static void increment() noexcept
+        {
+            size_t const   task  = lifecycle_task_table::current();
+            table_t* const table = table_.load(std::memory_order_acquire);
+            if(task != 0 && table != nullptr)
+                table->counts[task][static_cast<size_t>(Cnt)].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Counters of every task with at least one event, in order of first start
+        static std::vector<lifecycle_task_counters> get()
+        {
+            std::vector<lifecycle_task_counters> res;
+            table_t const* const                 table = table_.load(std::memory_order_acquire);
+            if(table == nullptr)
+                return res;
+            for(size_t task = 1; task < lifecycle_task_table::size(); ++task)
+            {
+                std::atomic<size_t> const(&counts)[6] = table->counts[task];
+                lifecycle_counters const cnts{counts[0].load(std::memory_order_relaxed),
+                                              counts[1].load(std::memory_order_relaxed),
+                                              counts[2].load(std::memory_order_relaxed),
+                                              counts[3].load(std::memory_order_relaxed),
+                                              counts[4].load(std::memory_order_relaxed),
+                                              counts[5].load(std::memory_order_relaxed)};
+                if(cnts == lifecycle_counters{})
+                    continue;
+                res.push_back({lifecycle_task_table::name(task),
+                               lifecycle_task_table::runs(task).load(std::memory_order_relaxed),
+                               cnts});
+            }
+            return res;
+        }
+
+        static void clear() noexcept
+        {
+            if(table_t* const table = table_.load(std::memory_order_acquire))
+                for(auto& counts : table->counts)
+                    for(std::atomic<size_t>& cnt : counts)
+                        cnt.store(0, std::memory_order_relaxed);
+        }
+
+    private:
+        QS_INLINE_VAR static std::atomic<table_t*> table_ QS_INLINE_VAR_INIT({});
+    };
+
+#if !defined(__cpp_inline_variables)
+    template<class Tracker>
+    std::atomic<typename lifecycle_task_breakdown<Tracker>::table_t*>
+        lifecycle_task_breakdown<Tracker>::table_{};
+#endif
+} // namespace intl
+
+
+// Kind of task, such as a request type, that the events of qs::lifecycle_tracker_mt are
+// attributed to while it is current. It is a small value, copied into the tasks and
+// coroutines that continue the work.
+class lifecycle_task_context
+{
+public:
+    // No task
+    constexpr lifecycle_task_context() noexcept = default;
+
+    // Start a run of the task `name`, counted in lifecycle_task_counters::runs. New names past
+    // QS_LIFECYCLE_TASK_CAPACITY give no task.
+    static lifecycle_task_context start(std::string const& name)
+    {
+        lifecycle_task_context const ctx{intl::lifecycle_task_table::intern(name)};
+        if(ctx.id_ != 0)
+            intl::lifecycle_task_table::runs(ctx.id_).fetch_add(1, std::memory_order_relaxed);
+        return ctx;
+    }
+
+    // Task of the calling thread
+    static lifecycle_task_context current() noexcept
+    {
+        return lifecycle_task_context{intl::lifecycle_task_table::current()};
+    }
+
+    // Name of the task, empty for no task
+    std::string name() const { return intl::lifecycle_task_table::name(id_); }
+
+    explicit operator bool() const noexcept { return id_ != 0; }
+
+    bool operator==(lifecycle_task_context const& rhs) const noexcept { return id_ == rhs.id_; }
+    bool operator!=(lifecycle_task_context const& rhs) const noexcept { return id_ != rhs.id_; }
+
+private:
+    friend class lifecycle_task_scope;
+    template<class Awaiter>
+    friend class lifecycle_task_awaiter;
+
+    constexpr explicit lifecycle_task_context(size_t id) noexcept
+        : id_(id)
+    {}
+
+    size_t id_ = 0;
+};
+
+
+// Make a task current on the calling thread, restoring the previous one on destruction. In a
+// coroutine, the lifecycle_carry_task awaiters given the scope hand it over to the thread that
+// resumes it, so that it restores the task that thread had. Only the innermost scope of a
+// coroutine may be live across a co_await, and it must be in the coroutine frame.
+class lifecycle_task_scope
+{
+public:
+    explicit lifecycle_task_scope(lifecycle_task_context ctx) noexcept
+        : previous_(intl::lifecycle_task_table::current())
+    {
+        intl::lifecycle_task_table::current() = ctx.id_;
+    }
+
+    ~lifecycle_task_scope() { intl::lifecycle_task_table::current() = previous_; }
+
+    lifecycle_task_scope(lifecycle_task_scope const&)            = delete;
+    lifecycle_task_scope& operator=(lifecycle_task_scope const&) = delete;
+
+private:
+    template<class Awaiter>
+    friend class lifecycle_task_awaiter;
+
+    // task of the thread the scope runs on, before it was made current there
+    size_t previous_;
+
+    // Give the thread back the task it had before the scope ran on it
+    void leave_() noexcept { intl::lifecycle_task_table::current() = previous_; }
+
+    // Run the scope on the calling thread, keeping the task it replaces
+    void enter_(size_t task) noexcept
+    {
+        previous_                             = intl::lifecycle_task_table::current();
+        intl::lifecycle_task_table::current() = task;
+    }
+};
+
+
+// Awaiter that carries the task of the awaiting coroutine across a suspension. The task is
+// captured when the awaiter is made. At the suspension the suspending thread gets back the task
+// it had before the coroutine ran on it, and the resuming thread keeps its own task until the
+// coroutine suspends again or the scope ends. Nothing is handed over when the coroutine does not
+// suspend. It forwards to an awaiter, not to an awaitable that needs operator co_await.
+template<class Awaiter>
+class lifecycle_task_awaiter
+{
+public:
+    lifecycle_task_awaiter(lifecycle_task_scope& scope, Awaiter awaiter)
+        : awaiter_(std::forward<Awaiter>(awaiter)),
+          ctx_(lifecycle_task_context::current()),
+          scope_(&scope)
+    {}
+
+    bool await_ready() { return awaiter_.await_ready(); }
+
+    template<class Handle>
+    auto await_suspend(Handle handle) -> decltype(std::declval<Awaiter&>().await_suspend(handle))
+    {
+        // the coroutine may already run on another thread when the forwarded call returns, so
+        // the thread is restored before and the members are not used after
+        suspended_ = true;
+        scope_->leave_();
+        return awaiter_.await_suspend(handle);
+    }
+
+    auto await_resume() -> decltype(std::declval<Awaiter&>().await_resume())
+    {
+        if(suspended_)
+            scope_->enter_(ctx_.id_);
+        suspended_ = false;
+        return awaiter_.await_resume();
+    }
+
+private:
+    Awaiter                awaiter_;
+    lifecycle_task_context ctx_;
+    lifecycle_task_scope*  scope_;
+    bool                   suspended_ = false;
+};
+
+// Wrap an awaiter, handing over `scope`, the innermost task scope of the coroutine:
+// `co_await qs::lifecycle_carry_task(scope, socket.async_read(buffer))`
+template<class Awaiter>
+lifecycle_task_awaiter<Awaiter> lifecycle_carry_task(lifecycle_task_scope& scope,
+                                                     Awaiter&&             awaiter)
+{
+    return lifecycle_task_awaiter<Awaiter>{scope, std::forward<Awaiter>(awaiter)};
+}
+
+
+
+class lifecycle_counter_context;
+
+namespace intl
+{
+    // Counters of one tracked type in a qs::lifecycle_counter_context. qs::lifecycle_tracker
+    // counts in `plain`, qs::lifecycle_tracker_mt in `shared`, and `fold` adds them to the
+    // counters in use on the calling thread.
+    struct lifecycle_context_block
+    {
+        lifecycle_counters  plain{};
+        std::atomic<size_t> shared[6]{};
+        void (*fold)(lifecycle_context_block const&) = nullptr;
+
+        lifecycle_counters load_shared() const noexcept
+        {
+            return {shared[0].load(std::memory_order_relaxed),
+                    shared[1].load(std::memory_order_relaxed),
+                    shared[2].load(std::memory_order_relaxed),
+                    shared[3].load(std::memory_order_relaxed),
+                    shared[4].load(std::memory_order_relaxed),
+                    shared[5].load(std::memory_order_relaxed)};
+        }
+
+        void reset() noexcept
+        {
+            plain = lifecycle_counters{};
+            for(std::atomic<size_t>& cnt : shared)
+                cnt.store(0, std::memory_order_relaxed);
+        }
+    };
+
+    // Work on the events of every tracked type, checked on the inlined hot path when no feature
+    // of the type is on
+    template<class Dummy = void>
+    struct lifecycle_global_work
+    {
+        enum : size_t
+        {
+            subscribers = 1, // set while a callback is attached to every type
+            context     = 2  // added for each installed qs::lifecycle_counter_scope
+        };
+
+        QS_INLINE_VAR static std::atomic<size_t> word QS_INLINE_VAR_INIT({});
+    };
+
+#if !defined(__cpp_inline_variables)
+    template<class Dummy>
+    std::atomic<size_t> lifecycle_global_work<Dummy>::word{};
+#endif
+
+    template<class Dummy = void>
+    struct lifecycle_context_globals
+    {
+        // Context of the calling thread
+        static lifecycle_counter_context*& current() noexcept
+        {
+            thread_local lifecycle_counter_context* ctx = nullptr;
+            return ctx;
+        }
+    };
+
+    // Whether a counter context may be current on some thread
+    inline bool has_counter_contexts() noexcept
+    {
+        return lifecycle_global_work<>::word.load(std::memory_order_relaxed) >=
+               lifecycle_global_work<>::context;
+    }
+
+    using lifecycle_context_fold = void (*)(lifecycle_context_block const&);
+
+    // Counters of the type Tracker, keyed by `key`, in the context of the calling thread, or
+    // nullptr. The block is cached per thread and type, so only the first event of the type
+    // in a context locks it.
+    template<class Tracker>
+    lifecycle_context_block* context_block(void const* key, lifecycle_context_fold fold);
+} // namespace intl
+
+
+// Counters that replace the static counters of every tracked type on the threads where it is
+// installed with qs::lifecycle_counter_scope. Tests that reset and compare counters can then
+// run in parallel, each in its own context. Only the counters move to the context: thread,
+// task and perf counters, leak stacks and logging stay global. Events count where they happen,
+// so an object that outlives its scope decrements the enclosing counters on destruction, and
+// their alive() can go below zero. The counters of qs::lifecycle_tracker are plain in a context
+// too: a context installed on several threads at once must only count mt trackers there.
+class lifecycle_counter_context
+{
+public:
+    lifecycle_counter_context();
+    ~lifecycle_counter_context();
+
+    lifecycle_counter_context(lifecycle_counter_context const&)            = delete;
+    lifecycle_counter_context& operator=(lifecycle_counter_context const&) = delete;
+
+    // Reset the counters of every type in this context
+    void reset();
+
+    // Add the counters of this context to the ones in use on the calling thread, those of its
+    // current context or the static ones, and reset them. Does nothing where this context is
+    // current. Counting a block of code in a context and merging it afterwards measures the
+    // block without hiding its events from the enclosing counters.
+    void merge();
+
+    // Context of the calling thread, or nullptr when the static counters are used
+    static lifecycle_counter_context* current() noexcept
+    {
+        return intl::lifecycle_context_globals<>::current();
+    }
+
+private:
+    template<class Tracker>
+    friend intl::lifecycle_context_block* intl::context_block(void const*                  key,
+                                                              intl::lifecycle_context_fold fold);
+
+    struct state_t;
+
+    // Distinct for every context, so that a block cached for a context is never used for
+    // another one created at the same address
+    static std::uint64_t next_id_() noexcept
+    {
+        static std::atomic<std::uint64_t> next{1};
+        return next.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Blocks are never erased and map nodes do not move, so they can be used without the lock
+    intl::lifecycle_context_block& block_(void const* key, intl::lifecycle_context_fold fold);
+
+    std::uint64_t const      id_{next_id_()};
+    std::unique_ptr<state_t> state_;
+};
+
+#if !QS_LIFECYCLE_DECLARE_ONLY
+struct lifecycle_counter_context::state_t
+{
+    std::mutex                                                     mutex;
+    std::unordered_map<void const*, intl::lifecycle_context_block> blocks;
+};
+
+QS_LIFECYCLE_API lifecycle_counter_context::lifecycle_counter_context()
+    : state_{new state_t{}}
+{}
+
+QS_LIFECYCLE_API lifecycle_counter_context::~lifecycle_counter_context() = default;
+
+QS_LIFECYCLE_API void lifecycle_counter_context::reset()
+{
+    std::lock_guard<std::mutex> const lock{state_->mutex};
+    for(auto& entry : state_->blocks)
+        entry.second.reset();
+}
+
+QS_LIFECYCLE_API void lifecycle_counter_context::merge()
+{
+    if(current() == this)
+        return;
+    std::vector<intl::lifecycle_context_block const*> blocks;
+    {
+        std::lock_guard<std::mutex> const lock{state_->mutex};
+        for(auto const& entry : state_->blocks)
+            blocks.push_back(&entry.second);
+    }
+    // outside of the lock, folding may lock the context of the calling thread
+    for(intl::lifecycle_context_block const* block : blocks)
+        block->fold(*block);
+    reset();
+}
+
+QS_LIFECYCLE_API intl::lifecycle_context_block&
+lifecycle_counter_context::block_(void const* key, intl::lifecycle_context_fold fold)
+{
+    std::lock_guard<std::mutex> const lock{state_->mutex};
+    intl::lifecycle_context_block&    block = state_->blocks[key];
+    block.fold                              = fold;
+    return block;
+}
+#endif
+
+
+namespace intl
+{
+    template<class Tracker>
+    lifecycle_context_block* context_block(void const* key, lifecycle_context_fold fold)
+    {
+        struct cache_t
+        {
+            std::uint64_t            context;
+            lifecycle_context_block* block;
+        };
+        // trivially destructible, so it is still usable from destructors after thread exit
+        thread_local cache_t cache{0, nullptr};
+
+        lifecycle_counter_context* const ctx = lifecycle_context_globals<>::current();
+        if(ctx == nullptr)
+            return nullptr;
+        if(cache.context != ctx->id_)
+            cache = {ctx->id_, &ctx->block_(key, fold)};
+        return cache.block;
+    }
+} // namespace intl
+
+
+// Install a counter context on the calling thread, restoring the previous one on destruction
+class lifecycle_counter_scope
+{
+public:
+    explicit lifecycle_counter_scope(lifecycle_counter_context& ctx) noexcept
+        : previous_(intl::lifecycle_context_globals<>::current())
+    {
+        intl::lifecycle_global_work<>::word.fetch_add(intl::lifecycle_global_work<>::context,
+                                                      std::memory_order_relaxed);
+        intl::lifecycle_context_globals<>::current() = &ctx;
+    }
+
+    ~lifecycle_counter_scope()
+    {
+        intl::lifecycle_context_globals<>::current() = previous_;
+        intl::lifecycle_global_work<>::word.fetch_sub(intl::lifecycle_global_work<>::context,
+                                                      std::memory_order_relaxed);
+    }
+
+    lifecycle_counter_scope(lifecycle_counter_scope const&)            = delete;
+    lifecycle_counter_scope& operator=(lifecycle_counter_scope const&) = delete;
+
+private:
+    lifecycle_counter_context* previous_;
+};
+
+// Hardware counters of one kind of copy or move of a tracked type, summed over its operations
+struct lifecycle_perf_counters
+{
+    lifecycle_event event;
+    size_t          operations; // all the operations while enabled
+    size_t          measured;   // the operations read with hardware counters
+    std::uint64_t   instructions;
+    std::uint64_t   cycles;
+    std::uint64_t   llc_misses;
+};
+
+
+#if QS_LIFECYCLE_TRACKER_PERF
+namespace intl
+{
+    // Hardware counters of the calling thread, opened on first use. Readings are kept on a
+    // stack, so that copies of tracked members nested in a tracked copy are measured too.
+    class lifecycle_perf_thread
+    {
+    public:
+        static lifecycle_perf_thread& local()
+        {
+            thread_local lifecycle_perf_thread perf;
+            return perf;
+        }
+
+        // Push the readings taken before the copy or move of `key`. When the stack is full, the
+        // oldest entry was left by a copy or move of T that threw, and is dropped.
+        void start(void const* key) noexcept;
+
+        // Pop the readings of `key` and get the differences, false if `key` was not started.
+        // Entries above it were started by operations that never stopped, and are dropped.
+        bool stop(void const* key, bool& valid, std::uint64_t (&deltas)[3]) noexcept;
+
+        // Pop the readings of `key` without reading the counters, for an operation not counted
+        void drop(void const* key) noexcept;
+
+        lifecycle_perf_thread(lifecycle_perf_thread const&)            = delete;
+        lifecycle_perf_thread& operator=(lifecycle_perf_thread const&) = delete;
+
+    private:
+        struct entry_t
+        {
+            void const*   key;
+            std::uint64_t values[3];
+            bool          valid;
+        };
+
+        lifecycle_perf_thread() noexcept;
+        ~lifecycle_perf_thread();
+
+        bool read_(std::uint64_t (&values)[3]) const noexcept;
+
+        void close_() noexcept;
+
+        int           fds_[3]      = {-1, -1, -1};
+        std::uint64_t overhead_[3] = {};
+        entry_t       stack_[QS_LIFECYCLE_PERF_DEPTH];
+        size_t        depth_ = 0;
+    };
+
+#if !QS_LIFECYCLE_DECLARE_ONLY
+    QS_LIFECYCLE_API void lifecycle_perf_thread::start(void const* key) noexcept
+    {
+        if(depth_ == QS_LIFECYCLE_PERF_DEPTH)
+            std::copy(stack_ + 1, stack_ + depth_--, stack_);
+        entry_t& entry = stack_[depth_++];
+        entry.key      = key;
+        entry.valid    = read_(entry.values);
+    }
+
+    QS_LIFECYCLE_API bool lifecycle_perf_thread::stop(void const* key, bool& valid,
+                                                      std::uint64_t (&deltas)[3]) noexcept
+    {
+        std::uint64_t now[3];
+        bool const    read = read_(now);
+        for(size_t i = depth_; i-- > 0;)
+        {
+            if(stack_[i].key != key)
+                continue;
+            depth_ = i;
+            valid  = read && stack_[i].valid;
+            for(size_t m = 0; valid && m < 3; ++m)
+            {
+                std::uint64_t const delta = now[m] - stack_[i].values[m];
+                deltas[m] = delta > overhead_[m] ? delta - overhead_[m] : 0;
+            }
+            return true;
+        }
+        return false;
+    }
+
+    QS_LIFECYCLE_API void lifecycle_perf_thread::drop(void const* key) noexcept
+    {
+        for(size_t i = depth_; i-- > 0;)
+            if(stack_[i].key == key)
+            {
+                depth_ = i;
+                return;
+            }
+    }
+
+    QS_LIFECYCLE_API lifecycle_perf_thread::lifecycle_perf_thread() noexcept
+    {
+#if QS_LIFECYCLE_TRACKER_WITH_PERF_EVENT
+        std::uint64_t const configs[3] = {PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CPU_CYCLES,
+                                          PERF_COUNT_HW_CACHE_MISSES};
+        for(size_t m = 0; m < 3; ++m)
+        {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.type           = PERF_TYPE_HARDWARE;
+            attr.size           = sizeof(attr);
+            attr.config         = configs[m];
+            attr.disabled       = m == 0;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv     = 1;
+            attr.read_format    = PERF_FORMAT_GROUP;
+            fds_[m] = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1,
+                                                 m == 0 ? -1 : fds_[0], 0UL));
+            if(fds_[m] < 0)
+            {
+                close_();
+                return;
+            }
+        }
+        ::ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+
+        // the cost of the reads themselves, subtracted from every measurement
+        std::uint64_t before[3], after[3];
+        for(std::uint64_t& overhead : overhead_)
+            overhead = ~std::uint64_t{0};
+        for(int i = 0; i < 8; ++i)
+            if(read_(before) && read_(after))
+                for(size_t m = 0; m < 3; ++m)
+                    overhead_[m] = (std::min)(overhead_[m], after[m] - before[m]);
+#endif
+    }
+
+    QS_LIFECYCLE_API lifecycle_perf_thread::~lifecycle_perf_thread()
+    {
+        close_();
+    }
+
+    QS_LIFECYCLE_API bool lifecycle_perf_thread::read_(std::uint64_t (&values)[3]) const noexcept
+    {
+#if QS_LIFECYCLE_TRACKER_WITH_PERF_EVENT
+        std::uint64_t group[4]; // the number of counters, then their values
+        if(fds_[0] < 0 || ::read(fds_[0], group, sizeof(group)) != sizeof(group))
+            return false;
+        std::copy(group + 1, group + 4, values);
+        return true;
+#else
+        ignore_unused(values);
+        return false;
+#endif
+    }
+
+    QS_LIFECYCLE_API void lifecycle_perf_thread::close_() noexcept
+    {
+#if QS_LIFECYCLE_TRACKER_WITH_PERF_EVENT
+        for(int& fd : fds_)
+        {
+            if(fd >= 0)
+                ::close(fd);
+            fd = -1;
+        }
+#endif
+    }
+#endif
+
+    // Hardware counters per copy and move event of one tracked type
+    template<class Tracker>
+    class lifecycle_perf_table
+    {
+    public:
+        QS_COLD QS_NOINLINE static void start(void const* key) noexcept
+        {
+            lifecycle_perf_thread::local().start(key);
+        }
+
+        template<lifecycle_event Cnt>
+        static void stop(void const* key) noexcept
+        {
+            bool          valid = false;
+            std::uint64_t deltas[3];
+            bool const    started = lifecycle_perf_thread::local().stop(key, valid, deltas);
+            std::atomic<std::uint64_t>(&sums)[5] = sums_[static_cast<size_t>(Cnt)];
+            sums[0].fetch_add(1, std::memory_order_relaxed);
+            if(!started || !valid)
+                return;
+            sums[1].fetch_add(1, std::memory_order_relaxed);
+            for(size_t m = 0; m < 3; ++m)
+                sums[2 + m].fetch_add(deltas[m], std::memory_order_relaxed);
+        }
+
+        static std::vector<lifecycle_perf_counters> get()
+        {
+            std::vector<lifecycle_perf_counters> res;
+            for(lifecycle_event const event :
+                {lifecycle_event::CopyConstructor, lifecycle_event::MoveConstructor,
+                 lifecycle_event::CopyAssignment, lifecycle_event::MoveAssignment})
+            {
+                std::atomic<std::uint64_t> const(&sums)[5] = sums_[static_cast<size_t>(event)];
+                res.push_back({event, static_cast<size_t>(sums[0].load(std::memory_order_relaxed)),
+                               static_cast<size_t>(sums[1].load(std::memory_order_relaxed)),
+                               sums[2].load(std::memory_order_relaxed),
+                               sums[3].load(std::memory_order_relaxed),
+                               sums[4].load(std::memory_order_relaxed)});
+            }
+            return res;
+        }
+
+        QS_COLD QS_NOINLINE static void drop(void const* key) noexcept
+        {
+            lifecycle_perf_thread::local().drop(key);
+        }
+
+        static void clear() noexcept
+        {
+            for(auto& sums : sums_)
+                for(std::atomic<std::uint64_t>& sum : sums)
+                    sum.store(0, std::memory_order_relaxed);
+        }
+
+    private:
+        // operations, measured operations, instructions, cycles and LLC misses per event
+        QS_INLINE_VAR static std::atomic<std::uint64_t> sums_[6][5] QS_INLINE_VAR_INIT({});
+    };
+
+#if !defined(__cpp_inline_variables)
+    template<class Tracker>
+    std::atomic<std::uint64_t> lifecycle_perf_table<Tracker>::sums_[6][5];
+#endif
+
+    inline namespace QS_LIFECYCLE_ABI
+    {
+        // Average hardware counters per copy and move, or a note when they could not be read
+        QS_LIFECYCLE_API void print_perf_report(lifecycle_sink* sink, std::string const& type_name,
+                                                size_t                                      uuid,
+                                                std::vector<lifecycle_perf_counters> const& perf)
+#if QS_LIFECYCLE_DECLARE_ONLY
+            ;
+#else
+        {
+            if(sink == nullptr)
+                return;
+            static char const* const names[6] = {"constructor",     "copy_constructor",
+                                                 "move_constructor", "copy_assignment",
+                                                 "move_assignment", "destructor"};
+            std::string out = "Lifecycle perf counters [type: " + type_name +
+                              ", uuid: " + std::to_string(uuid) + "]\n";
+            for(lifecycle_perf_counters const& p : perf)
+            {
+                if(p.operations == 0)
+                    continue;
+                out += " * " + std::string{names[static_cast<size_t>(p.event)]} + ": " +
+                       std::to_string(p.operations) + " ops";
+                if(p.measured == 0)
+                {
+                    out += ", hardware counters unavailable\n";
+                    continue;
+                }
+                char averages[160];
+                double const n = static_cast<double>(p.measured);
+                std::snprintf(averages, sizeof(averages),
+                              ", per op: %.1f instructions, %.1f cycles, %.2f LLC misses\n",
+                              static_cast<double>(p.instructions) / n,
+                              static_cast<double>(p.cycles) / n,
+                              static_cast<double>(p.llc_misses) / n);
+                out += averages;
+            }
+            lifecycle_log_line line{sink, true};
+            line.str() += out;
+        }
+#endif
+    } // namespace QS_LIFECYCLE_ABI
+} // namespace intl
+#endif
+
+
+// Overhead of one type, as listed by qs::lifecycle_overheads
+struct lifecycle_type_overhead
+{
+    std::string        type;
+    size_t             uuid;
+    lifecycle_overhead overhead;
+};
+
+
+namespace intl
+{
+    // Splits the time of an event into the parts of lifecycle_overhead, one steady_clock read
+    // per part. The cost of a read, calibrated once, is subtracted from every part.
+    class lifecycle_overhead_laps
+    {
+    public:
+        enum part : size_t
+        {
+            counting,
+            logging,
+            features
+        };
+
+        explicit lifecycle_overhead_laps(bool on) noexcept
+            : on_(on)
+        {
+            // calibrated before the first read, not within a part
+            if(on_)
+                static_cast<void>(bias_());
+            last_ = on_ ? now_() : 0;
+        }
+
+        bool on() const noexcept { return on_; }
+
+        // Add the time since the previous lap to a part
+        void lap(part p) noexcept
+        {
+            if(!on_)
+                return;
+            std::uint64_t const now  = now_();
+            std::uint64_t const time = now - last_;
+            std::uint64_t const bias = bias_();
+            ns[p] += time > bias ? time - bias : 0;
+            last_ = now;
+        }
+
+        std::uint64_t ns[3] = {};
+
+    private:
+        static std::uint64_t now_() noexcept;
+
+        static std::uint64_t bias_() noexcept;
+
+        bool          on_;
+        std::uint64_t last_ = 0;
+    };
+
+#if !QS_LIFECYCLE_DECLARE_ONLY
+    QS_LIFECYCLE_API std::uint64_t lifecycle_overhead_laps::now_() noexcept
+    {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                              std::chrono::steady_clock::now().time_since_epoch())
+                                              .count());
+    }
+
+    QS_LIFECYCLE_API std::uint64_t lifecycle_overhead_laps::bias_() noexcept
+    {
+        static std::uint64_t const bias = []
+        {
+            std::uint64_t least = ~std::uint64_t{0};
+            for(int i = 0; i < 64; ++i)
+            {
+                std::uint64_t const start = now_();
+                least                     = (std::min)(least, now_() - start);
+            }
+            return least;
+        }();
+        return bias;
+    }
+#endif
+
+    // Overhead of one tracked type, summed over its timed events
+    template<class Tracker>
+    class lifecycle_overhead_table
+    {
+    public:
+        static void add(lifecycle_overhead_laps const& laps) noexcept
+        {
+            events_.fetch_add(1, std::memory_order_relaxed);
+            for(size_t i = 0; i < 3; ++i)
+                ns_[i].fetch_add(laps.ns[i], std::memory_order_relaxed);
+        }
+
+        static lifecycle_overhead get() noexcept
+        {
+            return {events_.load(std::memory_order_relaxed),
+                    ns_[lifecycle_overhead_laps::counting].load(std::memory_order_relaxed),
+                    ns_[lifecycle_overhead_laps::logging].load(std::memory_order_relaxed),
+                    ns_[lifecycle_overhead_laps::features].load(std::memory_order_relaxed)};
+        }
+
+        static void clear() noexcept
+        {
+            events_.store(0, std::memory_order_relaxed);
+            for(std::atomic<std::uint64_t>& ns : ns_)
+                ns.store(0, std::memory_order_relaxed);
+        }
+
+    private:
+        QS_INLINE_VAR static std::atomic<size_t> events_       QS_INLINE_VAR_INIT({});
+        QS_INLINE_VAR static std::atomic<std::uint64_t> ns_[3] QS_INLINE_VAR_INIT({});
+    };
+
+#if !defined(__cpp_inline_variables)
+    template<class Tracker>
+    std::atomic<size_t> lifecycle_overhead_table<Tracker>::events_{};
+    template<class Tracker>
+    std::atomic<std::uint64_t> lifecycle_overhead_table<Tracker>::ns_[3];
+#endif
+
+    inline namespace QS_LIFECYCLE_ABI
+    {
+        // Append the overhead of a type, or of every type, with the average per event
+        QS_LIFECYCLE_API void format_overhead(std::string& out, std::string const& title,
+                                              lifecycle_overhead const& overhead)
+#if QS_LIFECYCLE_DECLARE_ONLY
+            ;
+#else
+        {
+            double const events =
+                static_cast<double>(overhead.events != 0 ? overhead.events : size_t{1});
+            std::pair<char const*, std::uint64_t> const parts[] = {
+                {"counting", overhead.counting_ns},
+                {"logging ", overhead.logging_ns},
+                {"features", overhead.features_ns}};
+            out += title + ": " + std::to_string(overhead.events) + " events, " +
+                   std::to_string(overhead.total_ns()) + " ns\n";
+            for(auto const& part : parts)
+            {
+                char line[96];
+                std::snprintf(line, sizeof(line), " * %s : %12llu ns (%.1f ns/event)\n",
+                              part.first, static_cast<unsigned long long>(part.second),
+                              static_cast<double>(part.second) / events);
+                out += line;
+            }
+        }
+#endif
+
+        QS_LIFECYCLE_API void print_overhead_report(lifecycle_sink* sink, std::string const& type_name,
+                                                    size_t uuid, lifecycle_overhead const& overhead)
+#if QS_LIFECYCLE_DECLARE_ONLY
+            ;
+#else
+        {
+            if(sink == nullptr)
+                return;
+            std::string out;
+            format_overhead(out,
+                            "Lifecycle overhead [type: " + type_name + ", uuid: " +
+                                std::to_string(uuid) + "]",
+                            overhead);
+            lifecycle_log_line line{sink, true};
+            line.str() += out;
+        }
+#endif
+    } // namespace QS_LIFECYCLE_ABI
+} // namespace intl
+
+
+// Instrumentation overhead of every type with timed events, see set_overhead_timing_enabled(),
+// and its total, to subtract from the timings of tracked builds
+class lifecycle_overheads
+{
+public:
+    // Overhead of every type with timed events, in order of registration in
+    // qs::lifecycle_registry
+    static std::vector<lifecycle_type_overhead> get_all();
+
+    // Overhead summed over every type
+    static lifecycle_overhead get_total();
+
+    // Print the overhead of every type, then the total
+    static void print_all(lifecycle_sink* sink = lifecycle_sinks::stderr_sink());
+};
+
+#if !QS_LIFECYCLE_DECLARE_ONLY
+QS_LIFECYCLE_API std::vector<lifecycle_type_overhead> lifecycle_overheads::get_all()
+{
+    std::vector<lifecycle_type_overhead> res;
+    for(size_t id = 0; id < lifecycle_registry::size(); ++id)
+    {
+        lifecycle_type_entry const* const entry = lifecycle_registry::get(id);
+        if(entry == nullptr || entry->overhead == nullptr)
+            continue;
+        lifecycle_overhead const overhead = entry->overhead();
+        if(overhead.events != 0)
+            res.push_back({entry->type_name(), entry->uuid, overhead});
+    }
+    return res;
+}
+
+QS_LIFECYCLE_API lifecycle_overhead lifecycle_overheads::get_total()
+{
+    lifecycle_overhead total{};
+    for(lifecycle_type_overhead const& type : get_all())
+        total += type.overhead;
+    return total;
+}
+
+QS_LIFECYCLE_API void lifecycle_overheads::print_all(lifecycle_sink* sink)
+{
+    if(sink == nullptr)
+        return;
+    std::string        out;
+    lifecycle_overhead total{};
+    for(lifecycle_type_overhead const& type : get_all())
+    {
+        intl::format_overhead(out,
+                              "Lifecycle overhead [type: " + type.type + ", uuid: " +
+                                  std::to_string(type.uuid) + "]",
+                              type.overhead);
+        total += type.overhead;
+    }
+    intl::format_overhead(out, "Lifecycle overhead total", total);
+    intl::lifecycle_log_line line{sink, true};
+    line.str() += out;
+}
+#endif
+
+
+namespace intl
+{
+    // Whether an lvalue of Fn can be called with Args, with a result that converts to R
+    template<class Fn, class Signature, class = void>
+    struct lifecycle_is_callable : std::false_type
+    {};
+
+    template<class Fn, class R, class... Args>
+    struct lifecycle_is_callable<Fn, R(Args...),
+                                 decltype(static_cast<void>(
+                                     std::declval<Fn&>()(std::declval<Args>()...)))>
+        : std::integral_constant<
+              bool, std::is_void<R>::value ||
+                        std::is_convertible<decltype(std::declval<Fn&>()(std::declval<Args>()...)),
+                                            R>::value>
+    {};
+} // namespace intl
+
+template<class Signature>
+class lifecycle_function;
+
+// Copyable callable of the callbacks and filters, in the role of std::function, which would make
+// every translation unit using a tracker include <functional>. A null function pointer or an
+// empty std::function makes an empty lifecycle_function.
+template<class R, class... Args>
+class lifecycle_function<R(Args...)>
+{
+public:
+    lifecycle_function() noexcept = default;
+
+    lifecycle_function(std::nullptr_t) noexcept {}
+
+    template<class Fn, class F = typename std::decay<Fn>::type,
+             typename std::enable_if<!std::is_same<F, lifecycle_function>::value &&
+                                         intl::lifecycle_is_callable<F, R(Args...)>::value,
+                                     int>::type = 0>
+    lifecycle_function(Fn&& fn)
+        : callable_{empty_(fn, 0) ? nullptr : new holder_t<F>{std::forward<Fn>(fn)}}
+    {}
+
+    lifecycle_function(lifecycle_function const& other)
+        : callable_{other.callable_ != nullptr ? other.callable_->clone() : nullptr}
+    {}
+
+    lifecycle_function(lifecycle_function&& other) noexcept
+        : callable_{other.callable_}
+    {
+        other.callable_ = nullptr;
+    }
+
+    lifecycle_function& operator=(lifecycle_function other) noexcept
+    {
+        std::swap(callable_, other.callable_);
+        return *this;
+    }
+
+    ~lifecycle_function() { delete callable_; }
+
+    explicit operator bool() const noexcept { return callable_ != nullptr; }
+
+    // Call the stored callable, which must not be empty
+    R operator()(Args... args) const { return callable_->call(std::forward<Args>(args)...); }
+
+private:
+    struct callable_t
+    {
+        virtual ~callable_t() = default;
+
+        virtual R           call(Args... args) = 0;
+        virtual callable_t* clone() const      = 0;
+    };
+
+    template<class F>
+    struct holder_t final : callable_t
+    {
+        template<class Fn>
+        explicit holder_t(Fn&& fn)
+            : fn(std::forward<Fn>(fn))
+        {}
+
+        R call(Args... args) override { return static_cast<R>(fn(std::forward<Args>(args)...)); }
+
+        callable_t* clone() const override { return new holder_t{fn}; }
+
+        F fn;
+    };
+
+    template<class Fn>
+    static auto empty_(Fn const& fn, int) noexcept -> decltype(!fn.operator bool())
+    {
+        return !fn.operator bool();
+    }
+
+    template<class Ret, class... Params>
+    static bool empty_(Ret (*fn)(Params...), int) noexcept
+    {
+        return fn == nullptr;
+    }
+
+    template<class Fn>
+    static bool empty_(Fn const&, long) noexcept
+    {
+        return false;
+    }
+
+    callable_t* callable_ = nullptr;
+};
+
+// Limits of a tracked type checked by its watchdog, 0 for no limit
+struct lifecycle_watchdog_limits
+{
+    size_t max_alive;
+    size_t max_constructions_per_sec; // constructor, copy and move constructor
+    size_t max_copies_per_sec;        // copy constructor and copy assignment
+};
+
+// Limit of lifecycle_watchdog_limits that was exceeded
+enum class lifecycle_watchdog_limit
+{
+    alive,
+    constructions_per_sec,
+    copies_per_sec
+};
+
+// Passed to the watchdog callback when a limit is first exceeded
+struct lifecycle_watchdog_alert
+{
+    lifecycle_watchdog_limit limit;
+    std::string const&       type_name;
+    size_t                   uuid;
+    size_t                   value; // alive objects, or events within the last second
+    size_t                   threshold;
+};
+
+using lifecycle_watchdog_callback = lifecycle_function<void(lifecycle_watchdog_alert const&)>;
+
+
+namespace intl
+{
+    // Watchdog of one tracked type. Checks run after the event is counted, on the counters that
+    // get_counters() returns. A rate only reads the clock once the events since the start of
+    // its window pass the limit: within a second it fires, later a new window starts.
+    class lifecycle_watchdog
+    {
+    public:
+        lifecycle_watchdog();
+        ~lifecycle_watchdog();
+
+        void set(lifecycle_watchdog_limits const& limits, lifecycle_counters const& cnts,
+                 lifecycle_watchdog_callback callback);
+
+        void check(lifecycle_event event, lifecycle_counters const& cnts,
+                   lifecycle_type_descriptor const& type, size_t uuid);
+
+    private:
+        struct rate_t;
+        struct state_t;
+        std::unique_ptr<state_t> state_;
+
+        static size_t constructions_(lifecycle_counters const& cnts) noexcept
+        {
+            return cnts.constructor + cnts.copy_constructor + cnts.move_constructor;
+        }
+
+        static size_t copies_(lifecycle_counters const& cnts) noexcept
+        {
+            return cnts.copy_constructor + cnts.copy_assignment;
+        }
+
+        static std::uint64_t now_() noexcept;
+
+        void check_rate_(rate_t& rate, size_t count, lifecycle_watchdog_limit which,
+                         lifecycle_type_descriptor const& type, size_t uuid);
+
+        // Call the callback, or write a warning to the sink of the type without one
+        void fire_(lifecycle_watchdog_limit which, size_t value, size_t threshold,
+                   lifecycle_type_descriptor const& type, size_t uuid);
+    };
+
+#if !QS_LIFECYCLE_DECLARE_ONLY
+    struct lifecycle_watchdog::rate_t
+    {
+        std::atomic<size_t>        limit{};
+        std::atomic<bool>          fired{};
+        std::atomic<size_t>        window_count{};
+        std::atomic<std::uint64_t> window_start{};
+
+        void arm(size_t max, size_t count) noexcept
+        {
+            limit.store(max, std::memory_order_relaxed);
+            fired.store(false, std::memory_order_relaxed);
+            window_count.store(count, std::memory_order_relaxed);
+            window_start.store(now_(), std::memory_order_relaxed);
+        }
+    };
+
+    struct lifecycle_watchdog::state_t
+    {
+        std::mutex                  mutex;
+        lifecycle_watchdog_callback callback;
+        std::atomic<size_t>         max_alive{};
+        std::atomic<bool>           alive_fired{};
+        rate_t                      rates[2];
+    };
+
+    QS_LIFECYCLE_API lifecycle_watchdog::lifecycle_watchdog()
+        : state_{new state_t{}}
+    {}
+
+    QS_LIFECYCLE_API lifecycle_watchdog::~lifecycle_watchdog() = default;
+
+    QS_LIFECYCLE_API void lifecycle_watchdog::set(lifecycle_watchdog_limits const& limits,
+                                                  lifecycle_counters const&        cnts,
+                                                  lifecycle_watchdog_callback      callback)
+    {
+        state_t&                    st = *state_;
+        std::lock_guard<std::mutex> lock{st.mutex};
+        st.callback = std::move(callback);
+        st.max_alive.store(limits.max_alive, std::memory_order_relaxed);
+        st.alive_fired.store(false, std::memory_order_relaxed);
+        st.rates[0].arm(limits.max_constructions_per_sec, constructions_(cnts));
+        st.rates[1].arm(limits.max_copies_per_sec, copies_(cnts));
+    }
+
+    QS_LIFECYCLE_API void lifecycle_watchdog::check(lifecycle_event event,
+                                                    lifecycle_counters const&        cnts,
+                                                    lifecycle_type_descriptor const& type,
+                                                    size_t                           uuid)
+    {
+        state_t& st = *state_;
+        if(event == lifecycle_event::Constructor || event == lifecycle_event::CopyConstructor ||
+           event == lifecycle_event::MoveConstructor)
+        {
+            size_t const max_alive = st.max_alive.load(std::memory_order_relaxed);
+            size_t const alive     = cnts.alive() > 0 ? static_cast<size_t>(cnts.alive()) : 0;
+            if(max_alive != 0 && alive > max_alive &&
+               !st.alive_fired.exchange(true, std::memory_order_relaxed))
+                fire_(lifecycle_watchdog_limit::alive, alive, max_alive, type, uuid);
+            check_rate_(st.rates[0], constructions_(cnts),
+                        lifecycle_watchdog_limit::constructions_per_sec, type, uuid);
+        }
+        if(event == lifecycle_event::CopyConstructor || event == lifecycle_event::CopyAssignment)
+            check_rate_(st.rates[1], copies_(cnts), lifecycle_watchdog_limit::copies_per_sec, type,
+                        uuid);
+    }
+
+    QS_LIFECYCLE_API std::uint64_t lifecycle_watchdog::now_() noexcept
+    {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                              std::chrono::steady_clock::now().time_since_epoch())
+                                              .count());
+    }
+
+    QS_LIFECYCLE_API void lifecycle_watchdog::check_rate_(rate_t& rate, size_t count,
+                                                          lifecycle_watchdog_limit         which,
+                                                          lifecycle_type_descriptor const& type,
+                                                          size_t                           uuid)
+    {
+        size_t const limit = rate.limit.load(std::memory_order_relaxed);
+        if(limit == 0 || rate.fired.load(std::memory_order_relaxed))
+            return;
+        size_t const start_count = rate.window_count.load(std::memory_order_relaxed);
+        // the counters were reset when they went back
+        if(count >= start_count && count - start_count <= limit)
+            return;
+        std::uint64_t const now = now_();
+        if(count >= start_count &&
+           now - rate.window_start.load(std::memory_order_relaxed) < 1000000000u)
+        {
+            if(!rate.fired.exchange(true, std::memory_order_relaxed))
+                fire_(which, count - start_count, limit, type, uuid);
+            return;
+        }
+        rate.window_start.store(now, std::memory_order_relaxed);
+        rate.window_count.store(count, std::memory_order_relaxed);
+    }
+
+    QS_LIFECYCLE_API void lifecycle_watchdog::fire_(lifecycle_watchdog_limit which, size_t value,
+                                                    size_t                           threshold,
+                                                    lifecycle_type_descriptor const& type,
+                                                    size_t                           uuid)
+    {
+        lifecycle_watchdog_callback callback;
+        {
+            std::lock_guard<std::mutex> lock{state_->mutex};
+            callback = state_->callback;
+        }
+        std::string const& name = type.type_name();
+        if(callback)
+            return callback(lifecycle_watchdog_alert{which, name, uuid, value, threshold});
+
+        static char const* const what[] = {"alive objects", "constructions in a second",
+                                           "copies in a second"};
+        lifecycle_sink* const    sink   = type.sink();
+        if(sink == nullptr)
+            return;
+        lifecycle_log_line line{sink, true};
+        line.str() += "Lifecycle watchdog [type: " + name + ", uuid: " + std::to_string(uuid) +
+                      "]: " + std::to_string(value) + " " + what[static_cast<size_t>(which)] +
+                      ", over the limit of " + std::to_string(threshold) + "\n";
+    }
+#endif
+
+    // Counters of the events that passed the log filter of one tracked type
+    template<class Tracker>
+    class lifecycle_heavy_counters
+    {
+    public:
+        template<lifecycle_event Cnt>
+        static void increment() noexcept
+        {
+            counts_[static_cast<size_t>(Cnt)].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        static lifecycle_counters get() noexcept
+        {
+            return {counts_[0].load(std::memory_order_relaxed),
+                    counts_[1].load(std::memory_order_relaxed),
+                    counts_[2].load(std::memory_order_relaxed),
+                    counts_[3].load(std::memory_order_relaxed),
+                    counts_[4].load(std::memory_order_relaxed),
+                    counts_[5].load(std::memory_order_relaxed)};
+        }
+
+        static void clear() noexcept
+        {
+            for(std::atomic<size_t>& count : counts_)
+                count.store(0, std::memory_order_relaxed);
+        }
+
+    private:
+        QS_INLINE_VAR static std::atomic<size_t> counts_[6] QS_INLINE_VAR_INIT({});
+    };
+
+#if !defined(__cpp_inline_variables)
+    template<class Tracker>
+    std::atomic<size_t> lifecycle_heavy_counters<Tracker>::counts_[6];
+#endif
+
+    inline namespace QS_LIFECYCLE_ABI
+    {
+        // Print the heavy events of a type in the layout of the counters
+        QS_LIFECYCLE_API void print_heavy_report(lifecycle_sink* sink, std::string const& type_name,
+                                                 size_t uuid, lifecycle_counters const& cnts)
+#if QS_LIFECYCLE_DECLARE_ONLY
+            ;
+#else
+        {
+            if(sink == nullptr)
+                return;
+            lifecycle_log_line line{sink, true};
+            format_counters(line.str(), cnts, type_name, uuid, "Lifecycle heavy events");
+        }
+#endif
+    } // namespace QS_LIFECYCLE_ABI
+} // namespace intl
+
+// Event passed to the callbacks of qs::lifecycle_subscribers and of the tracked types
+struct lifecycle_event_info
+{
+    lifecycle_event    event;
+    std::string const& type_name;
+    size_t             uuid;
+    bool               mt;
+    void const*        object; // the tracked object, a T const* for trackers of T
+};
+
+using lifecycle_callback = lifecycle_function<void(lifecycle_event_info const&)>;
+
+
+namespace intl
+{
+    template<class Derived, class T, size_t Uuid>
+    class lifecycle_tracker_mt_base;
+
+    // Check if a tracker base is the one of qs::lifecycle_tracker_mt
+    template<class Tracker>
+    struct is_mt_tracker : std::false_type
+    {};
+
+    template<class Derived, class T, size_t Uuid>
+    struct is_mt_tracker<lifecycle_tracker_mt_base<Derived, T, Uuid>> : std::true_type
+    {};
+
+    // Immutable list of callbacks, replaced as a whole when a callback is added or removed
+    struct lifecycle_subscriber_list
+    {
+        std::vector<std::pair<size_t, lifecycle_callback>> callbacks;
+    };
+
+    // RCU-style state shared by the subscriber lists and the log filters. Each thread announces
+    // its readers in a slot of its own, with the epoch they started in, and reads the current
+    // value without locking. Writers publish a new value under the mutex and retire the replaced
+    // one in a new epoch. It is freed once no reader is announced in an older epoch.
+    template<class Dummy = void>
+    struct lifecycle_rcu
+    {
+        // Readers of one thread. Slots are never freed, the slot of an exiting thread is reused.
+        struct reader_t
+        {
+            std::atomic<uint64_t> epoch{0}; // epoch of the outermost reader, 0 when none
+            std::atomic<bool>     used{true};
+            size_t                depth = 0; // nested readers, only used by the owning thread
+            reader_t*             next  = nullptr;
+            char                  padding[QS_CACHELINE_SIZE]; // apart from the next slot
+        };
+
+        QS_INLINE_VAR static std::atomic<uint64_t>  epoch QS_INLINE_VAR_INIT({1});
+        QS_INLINE_VAR static std::atomic<reader_t*> readers QS_INLINE_VAR_INIT({});
+        QS_INLINE_VAR static size_t                 next_id QS_INLINE_VAR_INIT({});
+
+        // Announces a reader in the slot of the calling thread. The seq_cst store of the epoch
+        // orders the loads of the values after it, which is what lifecycle_rcu_retire() relies
+        // on. A thread
+        // past its exit uses a slot for this reader only.
+        class reader_guard
+        {
+        public:
+            reader_guard()
+                : reader_{local()}, own_{reader_ == nullptr}
+            {
+                if(own_)
+                    reader_ = acquire();
+                if(reader_->depth++ == 0)
+                    reader_->epoch.store(epoch.load(std::memory_order_relaxed));
+            }
+
+            ~reader_guard()
+            {
+                if(--reader_->depth == 0)
+                    reader_->epoch.store(0, std::memory_order_release);
+                if(own_)
+                    release(reader_);
+            }
+
+            reader_guard(reader_guard const&)            = delete;
+            reader_guard& operator=(reader_guard const&) = delete;
+
+        private:
+            reader_t*  reader_;
+            bool const own_;
+        };
+
+        // Slot of the calling thread, or nullptr once it was given back at thread exit
+        static reader_t* local() noexcept
+        {
+            thread_local bool exited = false; // trivially destructible, outlives the handle
+            if(exited)
+                return nullptr;
+            thread_local handle_t handle{exited};
+            return handle.reader;
+        }
+
+        // Take a free slot, or add one
+        static reader_t* acquire()
+        {
+            for(reader_t* r = readers.load(std::memory_order_acquire); r != nullptr; r = r->next)
+            {
+                bool expected = false;
+                if(!r->used.load(std::memory_order_relaxed) &&
+                   r->used.compare_exchange_strong(expected, true, std::memory_order_acquire))
+                    return r;
+            }
+            auto* const r = new reader_t{};
+            r->next       = readers.load(std::memory_order_relaxed);
+            while(!readers.compare_exchange_weak(r->next, r, std::memory_order_release,
+                                                 std::memory_order_relaxed))
+            {}
+            return r;
+        }
+
+        static void release(reader_t* r) noexcept
+        {
+            r->used.store(false, std::memory_order_release);
+        }
+
+        // Oldest epoch that a reader can still be in, the current epoch when none is announced
+        static uint64_t oldest() noexcept
+        {
+            uint64_t res = epoch.load();
+            for(reader_t* r = readers.load(std::memory_order_acquire); r != nullptr; r = r->next)
+            {
+                uint64_t const e = r->epoch.load();
+                if(e != 0 && e < res)
+                    res = e;
+            }
+            return res;
+        }
+
+    private:
+        // Gives the slot back when the thread exits
+        struct handle_t
+        {
+            reader_t* reader;
+            bool&     exited;
+
+            explicit handle_t(bool& exited)
+                : reader{acquire()}, exited(exited)
+            {}
+
+            ~handle_t()
+            {
+                release(reader);
+                exited = true;
+            }
+
+            handle_t(handle_t const&)            = delete;
+            handle_t& operator=(handle_t const&) = delete;
+        };
+    };
+
+#if !defined(__cpp_inline_variables)
+    template<class Dummy>
+    std::atomic<uint64_t> lifecycle_rcu<Dummy>::epoch{1};
+    template<class Dummy>
+    std::atomic<typename lifecycle_rcu<Dummy>::reader_t*> lifecycle_rcu<Dummy>::readers{};
+    template<class Dummy>
+    size_t lifecycle_rcu<Dummy>::next_id{};
+#endif
+
+#if !QS_LIFECYCLE_DECLARE_ONLY
+    // Mutex of the writers of lifecycle_rcu. Leaked, so that subscriptions and filters can change
+    // during static destruction.
+    inline std::mutex& lifecycle_rcu_mutex()
+    {
+        static auto* const mtx = new std::mutex{};
+        return *mtx;
+    }
+
+    // Replaced value, with the function that frees it and the epoch it was retired in
+    struct lifecycle_rcu_retired
+    {
+        void const* value;
+        void (*free)(void const*);
+        uint64_t epoch;
+    };
+
+    // Retire a value replaced with the mutex held. A reader that starts after the exchange
+    // sees the new value, and one that saw the old value is announced in an earlier epoch
+    // than the one it is retired in, so it is free once the oldest reader is past it.
+    inline void lifecycle_rcu_retire(void const* value, void (*free)(void const*))
+    {
+        using rcu = lifecycle_rcu<>;
+        // guarded by the mutex
+        static auto* const retired = new std::vector<lifecycle_rcu_retired>{};
+
+        std::vector<lifecycle_rcu_retired>& values = *retired;
+        if(value != nullptr)
+            values.push_back({value, free, rcu::epoch.fetch_add(1) + 1});
+        uint64_t const oldest = rcu::oldest();
+        auto const     stale  = std::stable_partition(values.begin(), values.end(),
+                                                      [oldest](lifecycle_rcu_retired const& entry)
+                                                      { return entry.epoch > oldest; });
+        for(auto it = stale; it != values.end(); ++it)
+            it->free(it->value);
+        values.erase(stale, values.end());
+    }
+#endif
+
+    inline namespace QS_LIFECYCLE_ABI
+    {
+        // Publish `value` in `slot` under the mutex of the writers, and retire the value it
+        // replaces
+        QS_LIFECYCLE_API void lifecycle_rcu_replace(std::atomic<void const*>& slot,
+                                                    void const* value, void (*free)(void const*))
+#if QS_LIFECYCLE_DECLARE_ONLY
+            ;
+#else
+        {
+            std::lock_guard<std::mutex> const lock{lifecycle_rcu_mutex()};
+            lifecycle_rcu_retire(slot.exchange(value), free);
+        }
+#endif
+    } // namespace QS_LIFECYCLE_ABI
+
+    // Callbacks attached to one tracked type, or to all of them. Empty until the first
+    // subscription, so that checking it is a single pointer load.
+    class lifecycle_subscriber_slot
+    {
+        using rcu = lifecycle_rcu<>;
+
+    public:
+        bool empty() const noexcept { return head_.load(std::memory_order_relaxed) == nullptr; }
+
+        // Call every attached callback
+        void dispatch(lifecycle_event_info const& info) const
+        {
+            rcu::reader_guard const guard;
+            if(lifecycle_subscriber_list const* const list = head_.load())
+                for(auto const& callback : list->callbacks)
+                    callback.second(info);
+        }
+
+        // Attach a callback, returning its id
+        size_t add(lifecycle_callback callback);
+
+        // Detach a callback, returning false if it is not attached
+        bool remove(size_t id);
+
+        // Call `apply` with whether a callback is attached, under the mutex of the writers so
+        // that the last update wins
+        void update(void (*apply)(bool attached)) const;
+
+    private:
+        // Replace the list, with the mutex held
+        void publish_(lifecycle_subscriber_list const* list);
+
+        static void free_(void const* list)
+        {
+            delete static_cast<lifecycle_subscriber_list const*>(list);
+        }
+
+        std::atomic<lifecycle_subscriber_list const*> head_{nullptr};
+    };
+
+#if !QS_LIFECYCLE_DECLARE_ONLY
+    QS_LIFECYCLE_API size_t lifecycle_subscriber_slot::add(lifecycle_callback callback)
+    {
+        std::lock_guard<std::mutex> const lock{lifecycle_rcu_mutex()};
+        auto* const                       list = new lifecycle_subscriber_list{};
+        if(lifecycle_subscriber_list const* const old = head_.load())
+            list->callbacks = old->callbacks;
+        size_t const id = ++rcu::next_id;
+        list->callbacks.emplace_back(id, std::move(callback));
+        publish_(list);
+        return id;
+    }
+
+    QS_LIFECYCLE_API bool lifecycle_subscriber_slot::remove(size_t id)
+    {
+        std::lock_guard<std::mutex> const      lock{lifecycle_rcu_mutex()};
+        lifecycle_subscriber_list const* const old = head_.load();
+        if(old == nullptr)
+            return false;
+        auto const it = std::find_if(old->callbacks.begin(), old->callbacks.end(),
+                                     [id](std::pair<size_t, lifecycle_callback> const& callback)
+                                     { return callback.first == id; });
+        if(it == old->callbacks.end())
+            return false;
+        lifecycle_subscriber_list* list = nullptr;
+        if(old->callbacks.size() > 1)
+        {
+            list = new lifecycle_subscriber_list{};
+            list->callbacks.reserve(old->callbacks.size() - 1);
+            list->callbacks.insert(list->callbacks.end(), old->callbacks.begin(), it);
+            list->callbacks.insert(list->callbacks.end(), std::next(it), old->callbacks.end());
+        }
+        publish_(list);
+        return true;
+    }
+
+    QS_LIFECYCLE_API void lifecycle_subscriber_slot::update(void (*apply)(bool attached)) const
+    {
+        std::lock_guard<std::mutex> const lock{lifecycle_rcu_mutex()};
+        apply(!empty());
+    }
+
+    QS_LIFECYCLE_API void lifecycle_subscriber_slot::publish_(lifecycle_subscriber_list const* list)
+    {
+        lifecycle_rcu_retire(head_.exchange(list), &free_);
+    }
+#endif
+
+    // Callbacks attached to every tracked type
+    template<class Dummy = void>
+    struct lifecycle_subscriber_globals
+    {
+        QS_INLINE_VAR static lifecycle_subscriber_slot slot QS_INLINE_VAR_INIT({});
+    };
+
+#if !defined(__cpp_inline_variables)
+    template<class Dummy>
+    lifecycle_subscriber_slot lifecycle_subscriber_globals<Dummy>::slot{};
+#endif
+
+    // Log filter of one tracked type set at runtime. Filters are published and read in the
+    // same way as the subscriber lists, so that a filter can be replaced while another thread
+    // logs, and checking it takes no lock.
+    template<class Tracker, class T>
+    class lifecycle_log_filter_slot
+    {
+        using rcu = lifecycle_rcu<>;
+
+    public:
+        using filter_t = lifecycle_function<bool(T const&)>;
+
+        static void set(filter_t filter)
+        {
+            filter_t const* const next =
+                filter ? new filter_t const{std::move(filter)} : nullptr;
+            lifecycle_rcu_replace(filter_, next, &free_);
+        }
+
+        static bool call(T const& value)
+        {
+            rcu::reader_guard const guard;
+            auto const* const       filter = static_cast<filter_t const*>(filter_.load());
+            return filter == nullptr || (*filter)(value);
+        }
+
+    private:
+        static void free_(void const* filter) { delete static_cast<filter_t const*>(filter); }
+
+        // a filter_t, type-erased for lifecycle_rcu_replace()
+        QS_INLINE_VAR static std::atomic<void const*> filter_ QS_INLINE_VAR_INIT({nullptr});
+    };
+
+#if !defined(__cpp_inline_variables)
+    template<class Tracker, class T>
+    std::atomic<void const*> lifecycle_log_filter_slot<Tracker, T>::filter_{nullptr};
+#endif
+} // namespace intl
+
+
+// Callback attached by subscribe(), detached when the subscription is destroyed
+class lifecycle_subscription
+{
+public:
+    lifecycle_subscription() noexcept = default;
+
+    lifecycle_subscription(lifecycle_subscription&& other) noexcept
+        : detach_(other.detach_), id_(other.id_)
+    {
+        other.detach_ = nullptr;
+    }
+
+    lifecycle_subscription& operator=(lifecycle_subscription&& other) noexcept
+    {
+        if(this != &other)
+        {
+            unsubscribe();
+            detach_       = other.detach_;
+            id_           = other.id_;
+            other.detach_ = nullptr;
+        }
+        return *this;
+    }
+
+    ~lifecycle_subscription() { unsubscribe(); }
+
+    // Check if the callback is still attached through this subscription
+    explicit operator bool() const noexcept { return detach_ != nullptr; }
+
+    // Detach the callback now
+    void unsubscribe()
+    {
+        if(detach_ != nullptr)
+            detach_(id_);
+        detach_ = nullptr;
+    }
+
+    // Keep the callback attached for the rest of the program
+    void release() noexcept { detach_ = nullptr; }
+
+private:
+    template<class Tracker, class T, size_t Uuid>
+    friend class intl::lifecycle_tracker_common;
+    friend class lifecycle_subscribers;
+
+    lifecycle_subscription(void (*detach)(size_t), size_t id) noexcept
+        : detach_(detach), id_(id)
+    {}
+
+    void (*detach_)(size_t) = nullptr;
+    size_t id_              = 0;
+};
+
+
+// Callbacks on the events of every tracked type, in addition to the per-type subscribe()
+class lifecycle_subscribers
+{
+    using globals = intl::lifecycle_subscriber_globals<>;
+
+public:
+    // Call `callback` on every event of every tracked type, until the subscription is destroyed
+    static lifecycle_subscription subscribe(lifecycle_callback callback)
+    {
+        size_t const id = globals::slot.add(std::move(callback));
+        update_work_();
+        return {&unsubscribe_, id};
+    }
+
+    // Check if a callback is attached to every tracked type
+    static bool empty() noexcept { return globals::slot.empty(); }
+
+private:
+    using work = intl::lifecycle_global_work<>;
+
+    static void unsubscribe_(size_t id)
+    {
+        globals::slot.remove(id);
+        update_work_();
+    }
+
+    // Set the bit from the current list, under the lock so that the last update wins
+    static void update_work_()
+    {
+        globals::slot.update(
+            [](bool attached)
+            {
+                if(attached)
+                    work::word.fetch_or(work::subscribers, std::memory_order_relaxed);
+                else
+                    work::word.fetch_and(~size_t{work::subscribers}, std::memory_order_relaxed);
+            });
+    }
+};
+
+
+// Namespace for internal implementation details
+namespace intl
+{
+    // Optional per-type features. They share the atomic word of the enabled events, so the
+    // hot path checks both with a single load and only branches out when a feature is on.
+    enum lifecycle_feature : lifecycle_event_mask
+    {
+        feature_logging         = 1u << 7,
+        feature_leak_stacks     = 1u << 8,
+        feature_thread_counters = 1u << 9,
+        feature_cross_thread    = 1u << 10,
+        feature_missed_moves    = 1u << 11,
+        feature_subscribers     = 1u << 12,
+        feature_task_counters   = 1u << 13,
+        feature_perf_counters   = 1u << 14,
+        feature_overhead        = 1u << 15,
+        feature_watchdog        = 1u << 16,
+        feature_log_filter      = 1u << 17,
+        feature_move_quality    = 1u << 18
+    };
+
+    constexpr lifecycle_event_mask lifecycle_feature_mask = ~lifecycle_all_events;
+
+#if QS_LIFECYCLE_TRACKER_CONSTEXPR
+    // Link of a tracker to the qs::lifecycle_constexpr_context counting it
+    class lifecycle_constexpr_link
+    {
+    public:
+        constexpr lifecycle_constexpr_link() = default;
+        constexpr explicit lifecycle_constexpr_link(lifecycle_constexpr_context& context) noexcept
+            : context_{&context}
+        {}
+
+    protected:
+        constexpr void adopt_context_(lifecycle_constexpr_link const& other) noexcept
+        {
+            if(context_ == nullptr)
+                context_ = other.context_;
+        }
+
+        template<lifecycle_event Cnt>
+        constexpr void count_constexpr_() const noexcept
+        {
+            if(context_ != nullptr)
+                context_->template increment<Cnt>();
+        }
+
+    private:
+        lifecycle_constexpr_context* context_ = nullptr;
+    };
+#else
+    // Empty without QS_LIFECYCLE_TRACKER_CONSTEXPR, trackers keep their layout
+    class lifecycle_constexpr_link
+    {
+    protected:
+        QS_CONSTEXPR14 void adopt_context_(lifecycle_constexpr_link const&) noexcept {}
+
+        template<lifecycle_event Cnt>
+        QS_CONSTEXPR14 void count_constexpr_() const noexcept
+        {}
+    };
+#endif
+
+    // Static state and runtime configuration shared by both trackers, where Tracker is the
+    // qs::intl::lifecycle_tracker_base or qs::intl::lifecycle_tracker_mt_base owning it
+    template<class Tracker, class T, size_t Uuid>
+    class lifecycle_tracker_common
+    {
+    public:
+#if defined(__cpp_lib_string_view)
+        // Set type name using string_view
+        static QS_CONSTEXPR17 void set_type_name(std::string_view const type_name)
+        {
+            type_name_() = type_name;
+        }
+#else
+        // Set type name using char array
+        template<size_t N>
+        static QS_CONSTEXPR17 void set_type_name(char const (&type_name)[N])
+        {
+            type_name_().assign(type_name, N - 1);
         }
         // Set type name using string
         static QS_CONSTEXPR17 void set_type_name(std::string const& type_name)
         {
-            type_name_ = type_name;
+            type_name_() = type_name;
+        }
+#endif
+
+        // Get type name
+        static QS_CONSTEXPR14 std::string const& get_type_name()
+        {
+            if(type_name_().empty())
+                set_type_name(demangler<T>::get());
+            return type_name_();
+        }
+
+        // Set the sink used by the default logger for this type (nullptr disables logging)
+        static void set_sink(lifecycle_sink* sink)
+        {
+            lifecycle_sink_slot<T, Uuid>::set(sink);
+            refresh_sink_();
+        }
+
+        // Get the sink used by the default logger for this type
+        static lifecycle_sink* get_sink()
+        {
+            return lifecycle_sink_slot<T, Uuid>::get(get_type_name());
+        }
+
+        // Go back to the configured sink of this type, usually qs::lifecycle_sinks::get_default()
+        static void reset_sink()
+        {
+            lifecycle_sink_slot<T, Uuid>::reset();
+            set_flags_(feature_logging, true);
+        }
+
+        // Enable or disable counting and logging of every event
+        static void set_tracking_enabled(bool enabled)
+        {
+            set_enabled_events(enabled ? lifecycle_all_events : 0u);
+        }
+
+        // Enable or disable counting and logging of a single event
+        static void set_event_enabled(lifecycle_event event, bool enabled)
+        {
+            set_flags_(lifecycle_event_bit(event), enabled);
+        }
+
+        // Set the mask of tracked events
+        static void set_enabled_events(lifecycle_event_mask events)
+        {
+            lifecycle_event_mask flags = flags_.load(std::memory_order_relaxed);
+            while(!flags_.compare_exchange_weak(
+                flags, (flags & lifecycle_feature_mask) | (events & lifecycle_all_events),
+                std::memory_order_relaxed))
+            {}
+        }
+
+        // Get the mask of tracked events
+        static lifecycle_event_mask get_enabled_events()
+        {
+            return flags_.load(std::memory_order_relaxed) & lifecycle_all_events;
+        }
+
+        // Check if an event is tracked
+        static bool is_event_enabled(lifecycle_event event)
+        {
+            return (get_enabled_events() & lifecycle_event_bit(event)) != 0;
+        }
+
+        // Capture the construction stack of every new instance, to report the live ones later
+        static void set_leak_stacks_enabled(bool enabled)
+        {
+            if(enabled)
+                lifecycle_leaks::register_type_(&print_leaks);
+            set_flags_(feature_leak_stacks, enabled);
+            if(!enabled)
+                table_<lifecycle_instance_stacks>().clear();
+        }
+
+        // Get the construction stacks of live instances, most frequent first
+        static std::vector<lifecycle_leak_stack> get_leak_stacks(size_t max_stacks = 10)
+        {
+            return table_<lifecycle_instance_stacks>().leaks(max_stacks);
+        }
+
+        // Print the construction stacks of live instances, most frequent first
+        static void print_leaks(size_t          max_stacks = 10,
+                                lifecycle_sink* sink       = lifecycle_sinks::stderr_sink())
+        {
+            print_leak_report(sink, get_type_name(), Uuid,
+                              table_<lifecycle_instance_stacks>().size(),
+                              get_leak_stacks(max_stacks));
+        }
+
+        // Report copies whose source is destroyed by the same thread shortly after, which could
+        // have been moves
+        static void set_missed_moves_enabled(bool enabled)
+        {
+            set_flags_(feature_missed_moves, enabled);
+            if(!enabled)
+                lifecycle_missed_moves<Tracker>::clear();
+        }
+
+        // Get the copy sites of the suspected missed moves, most frequent first
+        static std::vector<lifecycle_missed_move> get_missed_moves(size_t max_sites = 10)
+        {
+            size_t total = 0;
+            return lifecycle_missed_moves<Tracker>::sites(max_sites, total);
+        }
+
+        // Print the number of suspected missed moves and their most frequent copy sites
+        static void print_missed_moves(size_t          max_sites = 10,
+                                       lifecycle_sink* sink      = lifecycle_sinks::stderr_sink())
+        {
+            size_t     total = 0;
+            auto const sites = lifecycle_missed_moves<Tracker>::sites(max_sites, total);
+            intl::print_missed_moves(sink, get_type_name(), Uuid, total, sites);
+        }
+
+        // Track which instances were moved from, to count the moves from moved-from objects,
+        // the copy assignments into them and their destructions
+        static void set_move_quality_enabled(bool enabled)
+        {
+            set_flags_(feature_move_quality, enabled);
+            if(!enabled)
+                table_<lifecycle_moved_from>().clear();
+        }
+
+        // Get the counts of the events that involve a moved-from object
+        static lifecycle_move_quality get_move_quality()
+        {
+            return table_<lifecycle_moved_from>().get();
+        }
+
+        // Print the counts of the events that involve a moved-from object
+        static void print_move_quality(lifecycle_sink* sink = lifecycle_sinks::stderr_sink())
+        {
+            intl::print_move_quality(sink, get_type_name(), Uuid, get_move_quality());
+        }
+
+        // Count the events of every thread separately, in addition to the totals
+        static void set_thread_counters_enabled(bool enabled)
+        {
+            set_flags_(feature_thread_counters, enabled);
+        }
+
+        // Get the counters of every live thread, followed by the "retired" bucket of the threads
+        // that exited
+        static std::vector<lifecycle_thread_counters> get_thread_counters()
+        {
+            return lifecycle_thread_breakdown<Tracker>::get();
+        }
+
+        // Count the events of every task context separately, see qs::lifecycle_task_context
+        static void set_task_counters_enabled(bool enabled)
+        {
+            if(enabled)
+                lifecycle_task_breakdown<Tracker>::allocate();
+            set_flags_(feature_task_counters, enabled);
+        }
+
+        // Get the counters of every task with events, in order of the first start of each task
+        static std::vector<lifecycle_task_counters> get_task_counters()
+        {
+            return lifecycle_task_breakdown<Tracker>::get();
+        }
+
+        // Record the creating thread of every new instance, to count the destructions that
+        // happen on another thread
+        static void set_cross_thread_enabled(bool enabled)
+        {
+            set_flags_(feature_cross_thread, enabled);
+            if(!enabled)
+                table_<lifecycle_instance_threads>().clear();
+        }
+
+        // Get the creator and destroyer threads of the cross-thread destructions, most frequent
+        // first
+        static std::vector<lifecycle_thread_pair> get_cross_thread_destructions()
+        {
+            return table_<lifecycle_instance_threads>().pairs();
+        }
+
+        // Print the creator and destroyer threads of the cross-thread destructions
+        static void print_cross_thread_destructions(
+            lifecycle_sink* sink = lifecycle_sinks::stderr_sink())
+        {
+            print_thread_pairs(sink, get_type_name(), Uuid, get_cross_thread_destructions());
+        }
+
+#if QS_LIFECYCLE_TRACKER_PERF
+        // Read instructions, cycles and LLC misses around every copy and move of T. Without
+        // hardware counters the operations are only counted.
+        static void set_perf_counters_enabled(bool enabled)
+        {
+            set_flags_(feature_perf_counters, enabled);
+        }
+
+        // Get the hardware counters of copies and moves, summed per event
+        static std::vector<lifecycle_perf_counters> get_perf_counters()
+        {
+            return lifecycle_perf_table<Tracker>::get();
+        }
+#endif
+
+        // Time the work of the tracker on every event of this type: counting, logging and the
+        // other features. Also listed by qs::lifecycle_overheads.
+        static void set_overhead_timing_enabled(bool enabled)
+        {
+            set_flags_(feature_overhead, enabled);
+        }
+
+        // Get the time spent by the tracker on the events of this type
+        static lifecycle_overhead get_overhead() noexcept
+        {
+            return lifecycle_overhead_table<Tracker>::get();
+        }
+
+        // Check the alive objects and the rates of constructions and copies of this type after
+        // each event. The first time a limit is exceeded, `callback` is called on the thread of
+        // the event, or a warning goes to the sink of the type. Setting the limits again re-arms
+        // them, and all zero limits disable the watchdog.
+        static void set_watchdog(lifecycle_watchdog_limits const&  limits,
+                                 lifecycle_watchdog_callback callback = {})
+        {
+            table_<lifecycle_watchdog>().set(limits, Tracker::get_counters(), std::move(callback));
+            set_flags_(feature_watchdog, limits.max_alive != 0 ||
+                                             limits.max_constructions_per_sec != 0 ||
+                                             limits.max_copies_per_sec != 0);
+        }
+
+        // Log only the events whose value passes `filter`, and count them in
+        // get_heavy_counters(). Replaces the qs::lifecycle_log_filter of the type, an empty
+        // filter restores it. Filters are only called while logging is enabled. A filter must
+        // not throw: it is also called in destructors, where an exception terminates.
+        static void set_log_filter(lifecycle_function<bool(T const&)> filter)
+        {
+            bool const enabled = static_cast<bool>(filter);
+            lifecycle_log_filter_slot<Tracker, T>::set(std::move(filter));
+            set_flags_(feature_log_filter, enabled);
+        }
+
+        // Get the counters of the logged events that passed the log filter
+        static lifecycle_counters get_heavy_counters() noexcept
+        {
+            return lifecycle_heavy_counters<Tracker>::get();
+        }
+
+        // Call `callback` on every event of this type, until the subscription is destroyed
+        static lifecycle_subscription subscribe(lifecycle_callback callback)
+        {
+            size_t const id = subscribers_.add(std::move(callback));
+            update_subscribed_();
+            return {&unsubscribe_, id};
+        }
+
+    protected:
+        template<class, class, class>
+        friend class lifecycle_perf_probe;
+
+        // Print the hardware counters and the overhead after the counters, when they are enabled
+        static void print_perf_counters_()
+        {
+#if QS_LIFECYCLE_TRACKER_PERF
+            if(flags_.load(std::memory_order_relaxed) & feature_perf_counters)
+                print_perf_report(get_sink(), get_type_name(), Uuid, get_perf_counters());
+#endif
+            if(flags_.load(std::memory_order_relaxed) & feature_overhead)
+                print_overhead_report(get_sink(), get_type_name(), Uuid, get_overhead());
+            if((flags_.load(std::memory_order_relaxed) & feature_log_filter) ||
+               !uses_default_filter::value)
+                print_heavy_report(get_sink(), get_type_name(), Uuid, get_heavy_counters());
+        }
+
+        // Check if a callback is attached to every tracked type
+        static bool has_global_subscribers_() noexcept
+        {
+            return !lifecycle_subscriber_globals<>::slot.empty();
+        }
+
+        // Check for global subscribers or counter contexts, the only check added to the inlined
+        // hot path when no feature of the type is on
+        static bool has_global_work_() noexcept
+        {
+            return lifecycle_global_work<>::word.load(std::memory_order_relaxed) != 0;
+        }
+
+        // A null sink skips the call to the default logger altogether. Called again for every
+        // registered type when qs::lifecycle_sinks is configured.
+        static void refresh_sink_()
+        {
+            set_flags_(feature_logging, !uses_default_logger::value || get_sink() != nullptr);
+        }
+
+        // Load the enabled events and features
+        static lifecycle_event_mask load_flags_() noexcept
+        {
+            return flags_.load(std::memory_order_relaxed);
+        }
+
+        // Handle an event that is switched off: with perf counters, drop the readings that the
+        // probe took if the event was switched off in between
+        template<lifecycle_event Cnt>
+        static QS_CONSTEXPR14 void skip_event_(lifecycle_event_mask flags, T const& value) noexcept
+        {
+#if QS_LIFECYCLE_TRACKER_PERF
+            if(Cnt != lifecycle_event::Constructor && Cnt != lifecycle_event::Destructor)
+                if(QS_UNLIKELY(flags & feature_perf_counters))
+                    lifecycle_perf_table<Tracker>::drop(std::addressof(value));
+#else
+            ignore_unused(flags, value);
+#endif
+        }
+
+        // Logging and per-instance work of the enabled features, kept out of the inlined hot path
+        template<lifecycle_event Cnt>
+        QS_COLD QS_NOINLINE static void on_features_(lifecycle_event_mask flags, void const* self,
+                                                     void const* source, T const& value)
+        {
+#if QS_LIFECYCLE_TRACKER_PERF
+            // first, so that the other features are not measured
+            if(flags & feature_perf_counters)
+                if(Cnt != lifecycle_event::Constructor && Cnt != lifecycle_event::Destructor)
+                    lifecycle_perf_table<Tracker>::template stop<Cnt>(std::addressof(value));
+#endif
+            lifecycle_overhead_laps laps{(flags & feature_overhead) != 0};
+            Tracker::template count_<Cnt>();
+            laps.lap(lifecycle_overhead_laps::counting);
+            if(flags & feature_watchdog)
+                table_<lifecycle_watchdog>().check(Cnt, Tracker::get_counters(), descriptor_,
+                                                   Uuid);
+            if(flags & feature_leak_stacks)
+            {
+                if(Cnt == lifecycle_event::Destructor)
+                    table_<lifecycle_instance_stacks>().on_destroy(self);
+                else if(Cnt != lifecycle_event::CopyAssignment &&
+                        Cnt != lifecycle_event::MoveAssignment)
+                    table_<lifecycle_instance_stacks>().on_construct(self, capture_stack(1));
+            }
+            if(flags & feature_thread_counters)
+                lifecycle_thread_breakdown<Tracker>::template increment<Cnt>();
+            if(flags & feature_task_counters)
+                lifecycle_task_breakdown<Tracker>::template increment<Cnt>();
+            if(flags & feature_cross_thread)
+            {
+                if(Cnt == lifecycle_event::Destructor)
+                    table_<lifecycle_instance_threads>().on_destroy(self);
+                else if(Cnt != lifecycle_event::CopyAssignment &&
+                        Cnt != lifecycle_event::MoveAssignment)
+                    table_<lifecycle_instance_threads>().on_construct(self);
+            }
+            if(flags & feature_missed_moves)
+            {
+                lifecycle_missed_moves<Tracker>::on_event();
+                if(Cnt == lifecycle_event::Destructor)
+                    lifecycle_missed_moves<Tracker>::on_destroy(self);
+                else if(Cnt == lifecycle_event::CopyConstructor ||
+                        Cnt == lifecycle_event::CopyAssignment)
+                    lifecycle_missed_moves<Tracker>::on_copy(source, Cnt, capture_stack(1));
+            }
+            if(flags & feature_move_quality)
+                table_<lifecycle_moved_from>().on_event(Cnt, self, source);
+            laps.lap(lifecycle_overhead_laps::features);
+            if(flags & feature_logging)
+            {
+                if(passes_log_filter_<Cnt>(flags, value))
+                    log_<Cnt>(value, uses_default_logger{});
+                laps.lap(lifecycle_overhead_laps::logging);
+            }
+            if((flags & feature_subscribers) || has_global_subscribers_())
+                notify_<Cnt>(flags, value);
+            if(laps.on())
+            {
+                laps.lap(lifecycle_overhead_laps::features);
+                lifecycle_overhead_table<Tracker>::add(laps);
+            }
+        }
+
+        // Static variables for enabled events and features, type name, and logger
+        QS_INLINE_VAR static std::atomic<lifecycle_event_mask> flags_
+            QS_INLINE_VAR_INIT({QS_LIFECYCLE_TRACKER_ENABLED_EVENTS | feature_logging});
+        QS_INLINE_VAR static lifecycle_logger<T, Uuid> logger_ QS_INLINE_VAR_INIT({});
+        QS_INLINE_VAR static lifecycle_subscriber_slot subscribers_ QS_INLINE_VAR_INIT({});
+
+        // Type name, allocated on first use so that trackers constructed during static
+        // initialization can log
+        static std::string& type_name_()
+        {
+            static auto* const name = new std::string{};
+            return *name;
+        }
+
+    private:
+        using uses_default_logger = is_default_logger<lifecycle_logger<T, Uuid>>;
+        using uses_default_filter = is_default_filter<lifecycle_log_filter<T, Uuid>>;
+
+        static constexpr lifecycle_type_descriptor descriptor_{&get_type_name, &get_sink};
+
+        // The default logger only needs the type, through the shared qs::intl::log_default_event
+        template<lifecycle_event Cnt>
+        static void log_(T const&, std::true_type)
+        {
+            log_default_event(descriptor_, Cnt);
+        }
+
+        template<lifecycle_event Cnt>
+        static void log_(T const& value, std::false_type)
+        {
+            logger_.template log_event<Cnt>(value, get_type_name());
+        }
+
+        // Check the runtime or compile-time log filter, counting the events that pass it
+        template<lifecycle_event Cnt>
+        static bool passes_log_filter_(lifecycle_event_mask flags, T const& value)
+        {
+            if(!(flags & feature_log_filter) && uses_default_filter::value)
+                return true;
+            bool const heavy = (flags & feature_log_filter)
+                                   ? lifecycle_log_filter_slot<Tracker, T>::call(value)
+                                   : lifecycle_log_filter<T, Uuid>{}(value);
+            if(heavy)
+                lifecycle_heavy_counters<Tracker>::template increment<Cnt>();
+            return heavy;
+        }
+
+        // Call the callbacks of this type, then the ones of every type
+        template<lifecycle_event Cnt>
+        static void notify_(lifecycle_event_mask flags, T const& value)
+        {
+            lifecycle_event_info const info{Cnt, get_type_name(), Uuid,
+                                            is_mt_tracker<Tracker>::value, std::addressof(value)};
+            if(flags & feature_subscribers)
+                subscribers_.dispatch(info);
+            lifecycle_subscriber_globals<>::slot.dispatch(info);
+        }
+
+        static void unsubscribe_(size_t id)
+        {
+            subscribers_.remove(id);
+            update_subscribed_();
+        }
+
+        // Set the feature bit from the current list, under the lock so that the last update wins
+        static void update_subscribed_()
+        {
+            subscribers_.update([](bool attached) { set_flags_(feature_subscribers, attached); });
+        }
+
+        // Side table of an optional feature for this type
+        template<class Table>
+        static Table& table_()
+        {
+            return lifecycle_side_table<Table, Tracker>();
+        }
+
+        static void set_flags_(lifecycle_event_mask bits, bool enabled)
+        {
+            if(enabled)
+                flags_.fetch_or(bits, std::memory_order_relaxed);
+            else
+                flags_.fetch_and(~bits, std::memory_order_relaxed);
+        }
+    };
+
+#if !defined(__cpp_inline_variables)
+    template<class Tracker, class T, size_t Uuid>
+    std::atomic<lifecycle_event_mask> lifecycle_tracker_common<Tracker, T, Uuid>::flags_{
+        QS_LIFECYCLE_TRACKER_ENABLED_EVENTS | feature_logging};
+    template<class Tracker, class T, size_t Uuid>
+    lifecycle_logger<T, Uuid> lifecycle_tracker_common<Tracker, T, Uuid>::logger_{};
+    template<class Tracker, class T, size_t Uuid>
+    lifecycle_subscriber_slot lifecycle_tracker_common<Tracker, T, Uuid>::subscribers_{};
+    template<class Tracker, class T, size_t Uuid>
+    constexpr lifecycle_type_descriptor lifecycle_tracker_common<Tracker, T, Uuid>::descriptor_;
+#endif
+
+    // Trackers that hold their T, see qs::tracked
+    template<class Derived>
+    struct is_composed_tracker : std::false_type
+    {};
+
+    template<class T, size_t Uuid>
+    struct is_composed_tracker<tracked<T, Uuid>> : std::true_type
+    {};
+
+    template<class T, size_t Uuid>
+    struct is_composed_tracker<tracked_mt<T, Uuid>> : std::true_type
+    {};
+
+    // The T value of a tracker, passed to its logger: its T base, or the T that qs::tracked holds
+    template<class T, class Derived>
+    QS_CONSTEXPR14 T const& tracked_value_(Derived const& self, std::true_type) noexcept
+    {
+        return self;
+    }
+
+    template<class T, class Derived>
+    QS_CONSTEXPR14 T const& tracked_value_(Derived const& self, std::false_type) noexcept
+    {
+        return self.get();
+    }
+
+    template<class T, class Derived>
+    QS_CONSTEXPR14 T const& tracked_value(Derived const& self) noexcept
+    {
+        return tracked_value_<T>(self, std::is_base_of<T, Derived>{});
+    }
+
+    // Storage of the T of qs::tracked, a base so that it is constructed before and destroyed
+    // after the tracker base, like the T base of qs::lifecycle_tracker
+    template<class T>
+    struct lifecycle_tracked_storage
+    {
+        template<class... Args>
+        QS_CONSTEXPR14 explicit lifecycle_tracked_storage(Args&&... args)
+            : value(std::forward<Args>(args)...)
+        {}
+
+        T value;
+    };
+
+    // First base of the trackers of a type T, so that its copies and moves run before the
+    // copies and moves of T. With perf counters enabled it takes the readings that the tracker
+    // base, constructed or assigned after T, compares against.
+#if QS_LIFECYCLE_TRACKER_PERF
+    template<class Derived, class T, class Tracker>
+    class lifecycle_perf_probe
+    {
+    public:
+        lifecycle_perf_probe() = default;
+
+        QS_CONSTEXPR17 lifecycle_perf_probe(lifecycle_perf_probe const&) noexcept
+        {
+            start_<lifecycle_event::CopyConstructor>();
+        }
+
+        QS_CONSTEXPR17 lifecycle_perf_probe(lifecycle_perf_probe&&) noexcept
+        {
+            start_<lifecycle_event::MoveConstructor>();
+        }
+
+        QS_CONSTEXPR17 lifecycle_perf_probe& operator=(lifecycle_perf_probe const&) noexcept
+        {
+            start_<lifecycle_event::CopyAssignment>();
+            return *this;
+        }
+
+        QS_CONSTEXPR17 lifecycle_perf_probe& operator=(lifecycle_perf_probe&&) noexcept
+        {
+            start_<lifecycle_event::MoveAssignment>();
+            return *this;
+        }
+
+    private:
+        // Only for the events that the tracker base counts, which pops the readings
+        template<lifecycle_event Cnt>
+        QS_CONSTEXPR17 void start_() const noexcept
+        {
+            if(is_constant_evaluated())
+                return;
+            lifecycle_event_mask const flags = Tracker::load_flags_();
+            // keyed by the T subobject, which the tracker base passes to the logger
+            if(QS_UNLIKELY((flags & feature_perf_counters) && (flags & lifecycle_event_bit(Cnt))))
+                lifecycle_perf_table<Tracker>::start(
+                    std::addressof(tracked_value<T>(*static_cast<Derived const*>(this))));
+        }
+    };
+#else
+    template<class Derived, class T, class Tracker>
+    class lifecycle_perf_probe
+    {};
+#endif
+
+    // Base class for tracking lifecycle events
+    template<class Derived, class T, size_t Uuid>
+    class lifecycle_tracker_base
+        : public lifecycle_tracker_common<lifecycle_tracker_base<Derived, T, Uuid>, T, Uuid>,
+          public lifecycle_constexpr_link
+    {
+        static_assert(std::is_class<T>::value || is_composed_tracker<Derived>::value,
+                      "T must be a class type, use qs::tracked<T> for other types");
+
+        using common = lifecycle_tracker_common<lifecycle_tracker_base, T, Uuid>;
+        using link   = lifecycle_constexpr_link;
+
+        friend common;
+
+    public:
+        // Constructor
+        QS_CONSTEXPR20 lifecycle_tracker_base()
+        {
+            log_and_increment<lifecycle_event::Constructor>();
+        }
+
+#if QS_LIFECYCLE_TRACKER_CONSTEXPR
+        // Constructor counting in a qs::lifecycle_constexpr_context
+        constexpr explicit lifecycle_tracker_base(lifecycle_constexpr_context& context)
+            : link(context)
+        {
+            log_and_increment<lifecycle_event::Constructor>();
+        }
+#endif
+
+        // Copy constructor
+        QS_CONSTEXPR20 lifecycle_tracker_base(lifecycle_tracker_base const& other)
+            : link(other)
+        {
+            log_and_increment<lifecycle_event::CopyConstructor>(std::addressof(other));
+        }
+
+        // Copy assignment operator
+        QS_CONSTEXPR20 lifecycle_tracker_base& operator=(lifecycle_tracker_base const& other)
+        {
+            if(this != std::addressof(other))
+            {
+                link::adopt_context_(other);
+                log_and_increment<lifecycle_event::CopyAssignment>(std::addressof(other));
+            }
+            return *this;
+        }
+
+        // Move constructor
+        QS_CONSTEXPR20 lifecycle_tracker_base(lifecycle_tracker_base&& other)
+            : link(other)
+        {
+            log_and_increment<lifecycle_event::MoveConstructor>(std::addressof(other));
+        }
+
+        // Move assignment operator
+        QS_CONSTEXPR20 lifecycle_tracker_base& operator=(lifecycle_tracker_base&& other)
+        {
+            if(this != std::addressof(other))
+            {
+                link::adopt_context_(other);
+                log_and_increment<lifecycle_event::MoveAssignment>(std::addressof(other));
+            }
+            return *this;
+        }
+
+        // Destructor
+        QS_CONSTEXPR20 ~lifecycle_tracker_base()
+        {
+            log_and_increment<lifecycle_event::Destructor>();
         }
+
+        // Reset lifecycle counters
+        static QS_CONSTEXPR17 void reset_counters()
+        {
+            if(!is_constant_evaluated() && has_counter_contexts())
+                if(lifecycle_context_block* const block = context_())
+                    return block->reset();
+            *row_ = lifecycle_counters{};
+            if(is_constant_evaluated())
+                return;
+#if QS_LIFECYCLE_TRACKER_PERF
+            lifecycle_perf_table<lifecycle_tracker_base>::clear();
 #endif
+            lifecycle_overhead_table<lifecycle_tracker_base>::clear();
+            lifecycle_heavy_counters<lifecycle_tracker_base>::clear();
+        }
 
-        // Get type name
-        static QS_CONSTEXPR14 std::string const& get_type_name()
+        // Get lifecycle counters, the ones of the counter context of the calling thread if any
+        static QS_CONSTEXPR14 lifecycle_counters const& get_counters()
         {
-            if(type_name_.empty())
-                set_type_name(demangler<T>::get());
-            return type_name_;
+            if(!is_constant_evaluated() && has_counter_contexts())
+                if(lifecycle_context_block* const block = context_())
+                    return block->plain;
+            return *row_;
+        }
+
+        // Print lifecycle counters
+        static QS_CONSTEXPR14 lifecycle_counters const& print_counters()
+        {
+            lifecycle_counters const& cnts = get_counters();
+            common::logger_.print_counters(cnts, common::get_type_name());
+            common::print_perf_counters_();
+            return cnts;
         }
 
     protected:
@@ -725,26 +5932,72 @@ namespace intl
         }
 
     private:
-        // Static variables for counters, type name, and logger
-        QS_INLINE_VAR static lifecycle_counters counters_      QS_INLINE_VAR_INIT({});
-        QS_INLINE_VAR static std::string type_name_            QS_INLINE_VAR_INIT({});
-        QS_INLINE_VAR static lifecycle_logger<T, Uuid> logger_ QS_INLINE_VAR_INIT({});
+        static size_t register_() noexcept
+        {
+            size_t const id = lifecycle_registry::add(
+                {&common::get_type_name, [] { return *row_; }, Uuid, false, typeid(T).name(),
+                 &common::refresh_sink_, &lifecycle_overhead_table<lifecycle_tracker_base>::get});
+            if(id < QS_LIFECYCLE_REGISTRY_CAPACITY)
+                row_ = lifecycle_counter_table<>::place(id, counters_);
+            if(lifecycle_sink_globals<>::env_applied.load(std::memory_order_seq_cst))
+                common::refresh_sink_();
+            return id;
+        }
+
+        // Static variables for counters and registration in qs::lifecycle_registry. The events
+        // before registration, or past a full registry, count in counters_, the others in the
+        // row of the type in lifecycle_counter_table.
+        QS_INLINE_VAR static lifecycle_counters  counters_ QS_INLINE_VAR_INIT({});
+        QS_INLINE_VAR static lifecycle_counters* row_      QS_INLINE_VAR_INIT({&counters_});
+        QS_INLINE_VAR static size_t const        type_id_  QS_INLINE_VAR_INIT({register_()});
 
         // Get reference to specific counter
         template<lifecycle_event Cnt>
-        static QS_CONSTEXPR11 size_t& get_counter() noexcept
+        static QS_CONSTEXPR11 size_t& get_counter(lifecycle_counters& cnts = *row_) noexcept
+        {
+            return std::get<static_cast<size_t>(Cnt)>(
+                std::tie(cnts.constructor, cnts.copy_constructor, cnts.move_constructor,
+                         cnts.copy_assignment, cnts.move_assignment, cnts.destructor));
+        }
+
+        // Counters of the counter context of the calling thread, or nullptr
+        static lifecycle_context_block* context_()
+        {
+            return context_block<lifecycle_tracker_base>(&counters_, &fold_);
+        }
+
+        // Count in the counter context of the calling thread, or in the static counters
+        template<lifecycle_event Cnt>
+        static void count_()
+        {
+            lifecycle_context_block* const block = has_counter_contexts() ? context_() : nullptr;
+            ++get_counter<Cnt>(block != nullptr ? block->plain : *row_);
+        }
+
+        // Add the counters of a merged counter context in the same way
+        static void fold_(lifecycle_context_block const& from)
         {
-            return std::get<static_cast<size_t>(Cnt)>(std::tie(
-                counters_.constructor, counters_.copy_constructor, counters_.move_constructor,
-                counters_.copy_assignment, counters_.move_assignment, counters_.destructor));
+            lifecycle_context_block* const block = has_counter_contexts() ? context_() : nullptr;
+            (block != nullptr ? block->plain : *row_) += from.plain;
         }
 
-        // Log event and increment counter
+        // Log event and increment counter, where source is the object copied or moved from
         template<lifecycle_event Cnt>
-        QS_CONSTEXPR17 void log_and_increment() const
+        QS_CONSTEXPR17 void log_and_increment(void const* source = nullptr) const
         {
+#if QS_LIFECYCLE_TRACKER_CONSTEXPR
+            if(is_constant_evaluated())
+                return link::template count_constexpr_<Cnt>();
+#endif
+            static_cast<void>(type_id_); // registers the type, no code generated
+            lifecycle_event_mask const flags = common::load_flags_();
+            if(!(flags & lifecycle_event_bit(Cnt)))
+                return common::template skip_event_<Cnt>(flags, tracked_value<T>(*self()));
+            // the features count the event themselves, after the checks of the counter contexts
+            if((flags & lifecycle_feature_mask) || common::has_global_work_())
+                return common::template on_features_<Cnt>(flags, this, source,
+                                                          tracked_value<T>(*self()));
             ++get_counter<Cnt>();
-            logger_.template log_event<Cnt>(*static_cast<T const*>(self()), get_type_name());
         }
     };
 
@@ -752,16 +6005,24 @@ namespace intl
     template<class Derived, class T, size_t Uuid>
     lifecycle_counters lifecycle_tracker_base<Derived, T, Uuid>::counters_{};
     template<class Derived, class T, size_t Uuid>
-    std::string lifecycle_tracker_base<Derived, T, Uuid>::type_name_{};
+    lifecycle_counters* lifecycle_tracker_base<Derived, T, Uuid>::row_{&counters_};
     template<class Derived, class T, size_t Uuid>
-    lifecycle_logger<T, Uuid> lifecycle_tracker_base<Derived, T, Uuid>::logger_{};
+    size_t const lifecycle_tracker_base<Derived, T, Uuid>::type_id_{register_()};
 #endif
 
     // Base class for tracking lifecycle events with multi-threading support
     template<class Derived, class T, size_t Uuid>
     class lifecycle_tracker_mt_base
+        : public lifecycle_tracker_common<lifecycle_tracker_mt_base<Derived, T, Uuid>, T, Uuid>,
+          public lifecycle_constexpr_link
     {
-        static_assert(std::is_class<T>::value, "T must be a class type");
+        static_assert(std::is_class<T>::value || is_composed_tracker<Derived>::value,
+                      "T must be a class type, use qs::tracked<T> for other types");
+
+        using common = lifecycle_tracker_common<lifecycle_tracker_mt_base, T, Uuid>;
+        using link   = lifecycle_constexpr_link;
+
+        friend common;
 
     public:
         // Constructor
@@ -770,24 +6031,38 @@ namespace intl
             log_and_increment<lifecycle_event::Constructor>();
         }
 
+#if QS_LIFECYCLE_TRACKER_CONSTEXPR
+        // Constructor counting in a qs::lifecycle_constexpr_context
+        constexpr explicit lifecycle_tracker_mt_base(lifecycle_constexpr_context& context)
+            : link(context)
+        {
+            log_and_increment<lifecycle_event::Constructor>();
+        }
+#endif
+
         // Copy constructor
-        QS_CONSTEXPR20 lifecycle_tracker_mt_base(lifecycle_tracker_mt_base const&)
+        QS_CONSTEXPR20 lifecycle_tracker_mt_base(lifecycle_tracker_mt_base const& other)
+            : link(other)
         {
-            log_and_increment<lifecycle_event::CopyConstructor>();
+            log_and_increment<lifecycle_event::CopyConstructor>(std::addressof(other));
         }
 
         // Copy assignment operator
         QS_CONSTEXPR20 lifecycle_tracker_mt_base& operator=(lifecycle_tracker_mt_base const& other)
         {
             if(this != std::addressof(other))
-                log_and_increment<lifecycle_event::CopyAssignment>();
+            {
+                link::adopt_context_(other);
+                log_and_increment<lifecycle_event::CopyAssignment>(std::addressof(other));
+            }
             return *this;
         }
 
         // Move constructor
-        QS_CONSTEXPR20 lifecycle_tracker_mt_base(lifecycle_tracker_mt_base&&) noexcept
+        QS_CONSTEXPR20 lifecycle_tracker_mt_base(lifecycle_tracker_mt_base&& other) noexcept
+            : link(other)
         {
-            log_and_increment<lifecycle_event::MoveConstructor>();
+            log_and_increment<lifecycle_event::MoveConstructor>(std::addressof(other));
         }
 
         // Move assignment operator
@@ -795,7 +6070,10 @@ namespace intl
         operator=(lifecycle_tracker_mt_base&& other) noexcept
         {
             if(this != std::addressof(other))
-                log_and_increment<lifecycle_event::MoveAssignment>();
+            {
+                link::adopt_context_(other);
+                log_and_increment<lifecycle_event::MoveAssignment>(std::addressof(other));
+            }
             return *this;
         }
 
@@ -808,15 +6086,27 @@ namespace intl
         // Reset lifecycle counters
         static QS_CONSTEXPR17 void reset_counters()
         {
+            if(!is_constant_evaluated() && has_counter_contexts())
+                if(lifecycle_context_block* const block = context_())
+                    return block->reset();
+
             // ensure all prior writes are visible after this fence
             std::atomic_thread_fence(std::memory_order_acquire);
 
-            get_counter<lifecycle_event::Constructor>().store(0, std::memory_order_relaxed);
-            get_counter<lifecycle_event::CopyConstructor>().store(0, std::memory_order_relaxed);
-            get_counter<lifecycle_event::MoveConstructor>().store(0, std::memory_order_relaxed);
-            get_counter<lifecycle_event::CopyAssignment>().store(0, std::memory_order_relaxed);
-            get_counter<lifecycle_event::MoveAssignment>().store(0, std::memory_order_relaxed);
-            get_counter<lifecycle_event::Destructor>().store(0, std::memory_order_relaxed);
+            for(size_t i = 0; i < 6; ++i)
+            {
+                get_counter_(i).store(0, std::memory_order_relaxed);
+                counters_.cells[i].value.store(0, std::memory_order_relaxed);
+            }
+            lifecycle_thread_breakdown<lifecycle_tracker_mt_base>::clear();
+            lifecycle_task_breakdown<lifecycle_tracker_mt_base>::clear();
+            if(is_constant_evaluated())
+                return;
+#if QS_LIFECYCLE_TRACKER_PERF
+            lifecycle_perf_table<lifecycle_tracker_mt_base>::clear();
+#endif
+            lifecycle_overhead_table<lifecycle_tracker_mt_base>::clear();
+            lifecycle_heavy_counters<lifecycle_tracker_mt_base>::clear();
 
             // prevent later operations from being reordered before this fence
             std::atomic_thread_fence(std::memory_order_release);
@@ -825,152 +6115,281 @@ namespace intl
         // Get lifecycle counters
         static QS_CONSTEXPR14 lifecycle_counters get_counters()
         {
-            lifecycle_counters res;
-
-            // ensure all prior writes are visible after this fence
-            std::atomic_thread_fence(std::memory_order_acquire);
-
-            // read all counters with relaxed memory order
-            // order of reading here is not important
-            res.constructor =
-                get_counter<lifecycle_event::Constructor>().load(std::memory_order_relaxed);
-            res.copy_constructor =
-                get_counter<lifecycle_event::CopyConstructor>().load(std::memory_order_relaxed);
-            res.move_constructor =
-                get_counter<lifecycle_event::MoveConstructor>().load(std::memory_order_relaxed);
-            res.copy_assignment =
-                get_counter<lifecycle_event::CopyAssignment>().load(std::memory_order_relaxed);
-            res.move_assignment =
-                get_counter<lifecycle_event::MoveAssignment>().load(std::memory_order_relaxed);
-            res.destructor =
-                get_counter<lifecycle_event::Destructor>().load(std::memory_order_relaxed);
-
-            // prevent later operations from being reordered before this fence
-            std::atomic_thread_fence(std::memory_order_release);
-
-            return res;
+            if(!is_constant_evaluated() && has_counter_contexts())
+                if(lifecycle_context_block* const block = context_())
+                    return block->load_shared();
+            return load_counters_();
         }
 
         // Print lifecycle counters
         static QS_CONSTEXPR14 lifecycle_counters print_counters()
         {
             lifecycle_counters const cnts = get_counters();
-            logger_.print_counters(cnts, get_type_name());
+            common::logger_.print_counters(cnts, common::get_type_name());
+            common::print_perf_counters_();
             return cnts;
         }
 
-#if defined(__cpp_lib_string_view)
-        // Set type name using string_view
-        static QS_CONSTEXPR17 void set_type_name(std::string_view const type_name)
+    protected:
+        // Get pointer to derived class
+        QS_CONSTEXPR14 Derived*       self() noexcept { return static_cast<Derived*>(this); }
+        QS_CONSTEXPR14 Derived const* self() const noexcept
         {
-            type_name_ = type_name;
+            return static_cast<Derived const*>(this);
         }
-#else
-        // Set type name using char array
-        template<size_t N>
-        static QS_CONSTEXPR17 void set_type_name(char const (&type_name)[N])
+
+    private:
+        using shared_row_t = typename lifecycle_counter_table<>::shared_row_t;
+
+        static size_t register_() noexcept
         {
-            type_name_.assign(type_name, N - 1);
+            size_t const id = lifecycle_registry::add(
+                {&common::get_type_name, &load_counters_, Uuid, true, typeid(T).name(),
+                 &common::refresh_sink_,
+                 &lifecycle_overhead_table<lifecycle_tracker_mt_base>::get});
+            if(lifecycle_sink_globals<>::env_applied.load(std::memory_order_seq_cst))
+                common::refresh_sink_();
+            if(id >= QS_LIFECYCLE_REGISTRY_CAPACITY)
+                return id;
+            // switch to the zeroed row, then move the counts over. Increments of the threads
+            // that loaded the old row before the switch stay in counters_ and are still read.
+            shared_row_t* const row = lifecycle_counter_table<>::place(id);
+            row_.store(row, std::memory_order_release);
+            for(size_t i = 0; i < 6; ++i)
+                row->cells[i].value.fetch_add(
+                    counters_.cells[i].value.exchange(0, std::memory_order_relaxed),
+                    std::memory_order_relaxed);
+            return id;
         }
-        // Set type name using string
-        static QS_CONSTEXPR17 void set_type_name(std::string const& type_name)
+
+        // Static counters of every thread
+        static lifecycle_counters load_counters_() noexcept
         {
-            type_name_ = type_name;
+            // ensure all prior writes are visible after this fence
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            // read all counters with relaxed memory order, in the row and in counters_ for the
+            // increments that raced with registration
+            shared_row_t const* const row = row_.load(std::memory_order_acquire);
+            lifecycle_counters        res = lifecycle_counter_table<>::load(*row);
+            if(row != &counters_)
+                res += lifecycle_counter_table<>::load(counters_);
+
+            // prevent later operations from being reordered before this fence
+            std::atomic_thread_fence(std::memory_order_release);
+
+            return res;
         }
-#endif
 
-        // Get type name
-        static QS_CONSTEXPR14 std::string const& get_type_name()
+        // Static variables for counters and registration in qs::lifecycle_registry. The events
+        // before registration, or past a full registry, count in counters_, the others in the
+        // row of the type in lifecycle_counter_table.
+        QS_INLINE_VAR static shared_row_t               counters_ QS_INLINE_VAR_INIT({});
+        QS_INLINE_VAR static std::atomic<shared_row_t*> row_      QS_INLINE_VAR_INIT({&counters_});
+        QS_INLINE_VAR static size_t const               type_id_  QS_INLINE_VAR_INIT({register_()});
+
+        // Get reference to specific counter
+        template<lifecycle_event Cnt>
+        static QS_CONSTEXPR11 std::atomic<size_t>& get_counter()
         {
-            if(type_name_.empty())
-                set_type_name(demangler<T>::get());
-            return type_name_;
+            return get_counter_(static_cast<size_t>(Cnt));
         }
 
-    protected:
-        // Get pointer to derived class
-        QS_CONSTEXPR14 Derived*       self() noexcept { return static_cast<Derived*>(this); }
-        QS_CONSTEXPR14 Derived const* self() const noexcept
+        static std::atomic<size_t>& get_counter_(size_t i) noexcept
         {
-            return static_cast<Derived const*>(this);
+            return row_.load(std::memory_order_acquire)->cells[i].value;
         }
 
-    private:
-        // Struct to hold atomic counter
-        struct alignas(QS_CACHELINE_SIZE) atomic_counter_t
+        // Counters of the counter context of the calling thread, or nullptr
+        static lifecycle_context_block* context_()
         {
-            std::atomic<size_t> value{};
-        };
-
-        // Static variables for counters, type name, and logger
-        QS_INLINE_VAR static atomic_counter_t                  counters_[6] QS_INLINE_VAR_INIT({});
-        QS_INLINE_VAR static std::string type_name_            QS_INLINE_VAR_INIT({});
-        QS_INLINE_VAR static lifecycle_logger<T, Uuid> logger_ QS_INLINE_VAR_INIT({});
+            return context_block<lifecycle_tracker_mt_base>(&counters_, &fold_);
+        }
 
-        // Get reference to specific counter
+        // Count in the counter context of the calling thread, or in the static counters
         template<lifecycle_event Cnt>
-        static QS_CONSTEXPR11 std::atomic<size_t>& get_counter()
+        static void count_()
+        {
+            lifecycle_context_block* const block = has_counter_contexts() ? context_() : nullptr;
+            (block != nullptr ? block->shared[static_cast<size_t>(Cnt)] : get_counter<Cnt>())
+                .fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Add the counters of a merged counter context in the same way
+        static void fold_(lifecycle_context_block const& from)
         {
-            return counters_[static_cast<size_t>(Cnt)].value;
+            lifecycle_context_block* const block = has_counter_contexts() ? context_() : nullptr;
+            for(size_t i = 0; i < 6; ++i)
+            {
+                size_t const value = from.shared[i].load(std::memory_order_relaxed);
+                if(value != 0)
+                    (block != nullptr ? block->shared[i] : get_counter_(i))
+                        .fetch_add(value, std::memory_order_relaxed);
+            }
         }
 
-        // Log event and increment counter
+        // Log event and increment counter, where source is the object copied or moved from
         template<lifecycle_event Cnt>
-        QS_CONSTEXPR17 void log_and_increment() const
+        QS_CONSTEXPR17 void log_and_increment(void const* source = nullptr) const
         {
+            // static counters cannot be used in constant expressions
+#if QS_LIFECYCLE_TRACKER_CONSTEXPR
+            if(is_constant_evaluated())
+                return link::template count_constexpr_<Cnt>();
+#endif
+            static_cast<void>(type_id_); // registers the type, no code generated
+            // a single relaxed load when the event is switched off
+            lifecycle_event_mask const flags = common::load_flags_();
+            if(!(flags & lifecycle_event_bit(Cnt)))
+                return common::template skip_event_<Cnt>(flags, tracked_value<T>(*self()));
+            // logging, the optional features, the subscribers and the counter contexts run in a
+            // cold function, which counts the event, when one of them is on.
+            // We go from Base -> Derived -> value_type and pass a value_type const& reference to
+            // the logger, which can use it to format the log message.
+            if((flags & lifecycle_feature_mask) || common::has_global_work_())
+                return common::template on_features_<Cnt>(flags, this, source,
+                                                          tracked_value<T>(*self()));
             // increment the appropriate counter for the lifecycle event
             get_counter<Cnt>().fetch_add(1, std::memory_order_relaxed);
-            // magic of logging occurs here, where we go from Base -> Derived: value_type, Base ->
-            // value_type we pass value_type const& reference to the logger which can be used to
-            // format the log message logger is customizable
-            logger_.template log_event<Cnt>(*static_cast<T const*>(self()), get_type_name());
         }
     };
 
 #if !defined(__cpp_inline_variables)
     template<class Derived, class T, size_t Uuid>
-    typename lifecycle_tracker_mt_base<Derived, T, Uuid>::atomic_counter_t
-        lifecycle_tracker_mt_base<Derived, T, Uuid>::counters_[6];
+    typename lifecycle_tracker_mt_base<Derived, T, Uuid>::shared_row_t
+        lifecycle_tracker_mt_base<Derived, T, Uuid>::counters_{};
     template<class Derived, class T, size_t Uuid>
-    std::string lifecycle_tracker_mt_base<Derived, T, Uuid>::type_name_{};
+    std::atomic<typename lifecycle_tracker_mt_base<Derived, T, Uuid>::shared_row_t*>
+        lifecycle_tracker_mt_base<Derived, T, Uuid>::row_{&counters_};
     template<class Derived, class T, size_t Uuid>
-    lifecycle_logger<T, Uuid> lifecycle_tracker_mt_base<Derived, T, Uuid>::logger_{};
+    size_t const lifecycle_tracker_mt_base<Derived, T, Uuid>::type_id_{register_()};
 #endif
 
 } // namespace intl
 
 
 // Lifecycle tracker class
-template<class T, size_t Uuid = 0>
-class lifecycle_tracker : public T,
-                          public intl::lifecycle_tracker_base<lifecycle_tracker<T, Uuid>, T, Uuid>
+template<class T, size_t Uuid>
+class lifecycle_tracker
+    : public intl::lifecycle_perf_probe<lifecycle_tracker<T, Uuid>, T,
+                                        intl::lifecycle_tracker_base<lifecycle_tracker<T, Uuid>, T, Uuid>>,
+      public T,
+      public intl::lifecycle_tracker_base<lifecycle_tracker<T, Uuid>, T, Uuid>
 {
     using tracker = intl::lifecycle_tracker_base<lifecycle_tracker<T, Uuid>, T, Uuid>;
 
 public:
     using T::T;
+#if QS_LIFECYCLE_TRACKER_CONSTEXPR
+    lifecycle_tracker() = default;
+
+    // Construct with T(args...) and count the events of this object, and of the copies and moves
+    // made from it, in `context` during constant evaluation
+    template<class... Args>
+    constexpr lifecycle_tracker(lifecycle_constexpr_context& context, Args&&... args)
+        : T(std::forward<Args>(args)...), tracker(context)
+    {}
+#endif
     using tracker::get_counters;
+    using tracker::get_enabled_events;
+    using tracker::get_heavy_counters;
+    using tracker::get_leak_stacks;
+    using tracker::get_missed_moves;
+    using tracker::get_move_quality;
+    using tracker::get_overhead;
+#if QS_LIFECYCLE_TRACKER_PERF
+    using tracker::get_perf_counters;
+#endif
+    using tracker::get_sink;
     using tracker::get_type_name;
+    using tracker::is_event_enabled;
     using tracker::print_counters;
+    using tracker::print_leaks;
+    using tracker::print_missed_moves;
+    using tracker::print_move_quality;
     using tracker::reset_counters;
+    using tracker::reset_sink;
+    using tracker::set_enabled_events;
+    using tracker::set_event_enabled;
+    using tracker::set_leak_stacks_enabled;
+    using tracker::set_log_filter;
+    using tracker::set_missed_moves_enabled;
+    using tracker::set_move_quality_enabled;
+    using tracker::set_overhead_timing_enabled;
+#if QS_LIFECYCLE_TRACKER_PERF
+    using tracker::set_perf_counters_enabled;
+#endif
+    using tracker::set_sink;
+    using tracker::set_tracking_enabled;
     using tracker::set_type_name;
+    using tracker::set_watchdog;
+    using tracker::subscribe;
 };
 
 // Lifecycle tracker class with multi-threading support
-template<class T, size_t Uuid = 0>
+template<class T, size_t Uuid>
 class lifecycle_tracker_mt
-    : public T,
+    : public intl::lifecycle_perf_probe<
+          lifecycle_tracker_mt<T, Uuid>, T,
+          intl::lifecycle_tracker_mt_base<lifecycle_tracker_mt<T, Uuid>, T, Uuid>>,
+      public T,
       public intl::lifecycle_tracker_mt_base<lifecycle_tracker_mt<T, Uuid>, T, Uuid>
 {
     using tracker = intl::lifecycle_tracker_mt_base<lifecycle_tracker_mt<T, Uuid>, T, Uuid>;
 
 public:
     using T::T;
+#if QS_LIFECYCLE_TRACKER_CONSTEXPR
+    lifecycle_tracker_mt() = default;
+
+    // Construct with T(args...) and count the events of this object, and of the copies and moves
+    // made from it, in `context` during constant evaluation
+    template<class... Args>
+    constexpr lifecycle_tracker_mt(lifecycle_constexpr_context& context, Args&&... args)
+        : T(std::forward<Args>(args)...), tracker(context)
+    {}
+#endif
     using tracker::get_counters;
+    using tracker::get_cross_thread_destructions;
+    using tracker::get_enabled_events;
+    using tracker::get_heavy_counters;
+    using tracker::get_leak_stacks;
+    using tracker::get_missed_moves;
+    using tracker::get_move_quality;
+    using tracker::get_overhead;
+#if QS_LIFECYCLE_TRACKER_PERF
+    using tracker::get_perf_counters;
+#endif
+    using tracker::get_sink;
+    using tracker::get_task_counters;
+    using tracker::get_thread_counters;
     using tracker::get_type_name;
+    using tracker::is_event_enabled;
     using tracker::print_counters;
+    using tracker::print_cross_thread_destructions;
+    using tracker::print_leaks;
+    using tracker::print_missed_moves;
+    using tracker::print_move_quality;
     using tracker::reset_counters;
+    using tracker::reset_sink;
+    using tracker::set_cross_thread_enabled;
+    using tracker::set_enabled_events;
+    using tracker::set_event_enabled;
+    using tracker::set_leak_stacks_enabled;
+    using tracker::set_log_filter;
+    using tracker::set_missed_moves_enabled;
+    using tracker::set_move_quality_enabled;
+    using tracker::set_overhead_timing_enabled;
+#if QS_LIFECYCLE_TRACKER_PERF
+    using tracker::set_perf_counters_enabled;
+#endif
+    using tracker::set_sink;
+    using tracker::set_task_counters_enabled;
+    using tracker::set_thread_counters_enabled;
+    using tracker::set_tracking_enabled;
     using tracker::set_type_name;
+    using tracker::set_watchdog;
+    using tracker::subscribe;
 };
 
 // Specialization for void type
@@ -983,34 +6402,341 @@ class lifecycle_tracker<void, Uuid>
                                                  lifecycle_tracker<void, Uuid>, Uuid>;
 
 public:
+#if QS_LIFECYCLE_TRACKER_CONSTEXPR
+    lifecycle_tracker() = default;
+
+    // Construct and count the events of this object in `context` during constant evaluation
+    constexpr explicit lifecycle_tracker(lifecycle_constexpr_context& context)
+        : tracker(context)
+    {}
+
+#endif
     using tracker::get_counters;
+    using tracker::get_enabled_events;
+    using tracker::get_heavy_counters;
+    using tracker::get_leak_stacks;
+    using tracker::get_missed_moves;
+    using tracker::get_move_quality;
+    using tracker::get_overhead;
+    using tracker::get_sink;
     using tracker::get_type_name;
+    using tracker::is_event_enabled;
     using tracker::print_counters;
+    using tracker::print_leaks;
+    using tracker::print_missed_moves;
+    using tracker::print_move_quality;
     using tracker::reset_counters;
+    using tracker::reset_sink;
+    using tracker::set_enabled_events;
+    using tracker::set_event_enabled;
+    using tracker::set_leak_stacks_enabled;
+    using tracker::set_log_filter;
+    using tracker::set_missed_moves_enabled;
+    using tracker::set_move_quality_enabled;
+    using tracker::set_overhead_timing_enabled;
+    using tracker::set_sink;
+    using tracker::set_tracking_enabled;
     using tracker::set_type_name;
+    using tracker::set_watchdog;
+    using tracker::subscribe;
 };
 
 template<size_t Uuid>
 class lifecycle_tracker_mt<void, Uuid>
-    : public intl::lifecycle_tracker_mt_base<lifecycle_tracker<void, Uuid>,
-                                             lifecycle_tracker<void, Uuid>, Uuid>
+    : public intl::lifecycle_tracker_mt_base<lifecycle_tracker_mt<void, Uuid>,
+                                             lifecycle_tracker_mt<void, Uuid>, Uuid>
 {
     using tracker = intl::lifecycle_tracker_mt_base<lifecycle_tracker_mt<void, Uuid>,
                                                     lifecycle_tracker_mt<void, Uuid>, Uuid>;
 
 public:
+#if QS_LIFECYCLE_TRACKER_CONSTEXPR
+    lifecycle_tracker_mt() = default;
+
+    // Construct and count the events of this object in `context` during constant evaluation
+    constexpr explicit lifecycle_tracker_mt(lifecycle_constexpr_context& context)
+        : tracker(context)
+    {}
+
+#endif
+    using tracker::get_counters;
+    using tracker::get_cross_thread_destructions;
+    using tracker::get_enabled_events;
+    using tracker::get_heavy_counters;
+    using tracker::get_leak_stacks;
+    using tracker::get_missed_moves;
+    using tracker::get_move_quality;
+    using tracker::get_overhead;
+    using tracker::get_sink;
+    using tracker::get_task_counters;
+    using tracker::get_thread_counters;
+    using tracker::get_type_name;
+    using tracker::is_event_enabled;
+    using tracker::print_counters;
+    using tracker::print_cross_thread_destructions;
+    using tracker::print_leaks;
+    using tracker::print_missed_moves;
+    using tracker::print_move_quality;
+    using tracker::reset_counters;
+    using tracker::reset_sink;
+    using tracker::set_cross_thread_enabled;
+    using tracker::set_enabled_events;
+    using tracker::set_event_enabled;
+    using tracker::set_leak_stacks_enabled;
+    using tracker::set_log_filter;
+    using tracker::set_missed_moves_enabled;
+    using tracker::set_move_quality_enabled;
+    using tracker::set_overhead_timing_enabled;
+    using tracker::set_sink;
+    using tracker::set_task_counters_enabled;
+    using tracker::set_thread_counters_enabled;
+    using tracker::set_tracking_enabled;
+    using tracker::set_type_name;
+    using tracker::set_watchdog;
+    using tracker::subscribe;
+};
+
+// Lifecycle tracker that holds a T instead of deriving from it, for scalar, pointer, enum and final
+// types. It is the size of T when T is trivially copyable, and converts to T& implicitly.
+template<class T, size_t Uuid>
+class tracked
+    : public intl::lifecycle_perf_probe<tracked<T, Uuid>, T,
+                                        intl::lifecycle_tracker_base<tracked<T, Uuid>, T, Uuid>>,
+      private intl::lifecycle_tracked_storage<T>,
+      public intl::lifecycle_tracker_base<tracked<T, Uuid>, T, Uuid>
+{
+    using storage = intl::lifecycle_tracked_storage<T>;
+    using tracker = intl::lifecycle_tracker_base<tracked<T, Uuid>, T, Uuid>;
+
+public:
+    using value_type = T;
+    using pointer    = typename std::conditional<std::is_pointer<T>::value, T, T*>::type;
+
+    // Value-initialize T
+    QS_CONSTEXPR20 tracked()
+        : storage()
+    {}
+
+    // Copy or move value into T
+    QS_CONSTEXPR20 tracked(T const& value)
+        : storage(value)
+    {}
+    QS_CONSTEXPR20 tracked(T&& value)
+        : storage(std::move(value))
+    {}
+
+    // Construct T from two or more arguments
+    template<class Arg0, class Arg1, class... Args>
+    QS_CONSTEXPR20 tracked(Arg0&& arg0, Arg1&& arg1, Args&&... args)
+        : storage(std::forward<Arg0>(arg0), std::forward<Arg1>(arg1), std::forward<Args>(args)...)
+    {}
+#if QS_LIFECYCLE_TRACKER_CONSTEXPR
+
+    // Construct with T(args...) and count the events of this object, and of the copies and moves
+    // made from it, in `context` during constant evaluation
+    template<class... Args>
+    constexpr tracked(lifecycle_constexpr_context& context, Args&&... args)
+        : storage(std::forward<Args>(args)...), tracker(context)
+    {}
+#endif
+
+    // Access the held T
+    QS_CONSTEXPR14 T&       get() noexcept { return storage::value; }
+    QS_CONSTEXPR14 T const& get() const noexcept { return storage::value; }
+
+    QS_CONSTEXPR14 T&       operator*() noexcept { return storage::value; }
+    QS_CONSTEXPR14 T const& operator*() const noexcept { return storage::value; }
+
+    // The held pointer when T is a pointer, the address of T otherwise
+    QS_CONSTEXPR14 pointer operator->() noexcept
+    {
+        return arrow_(storage::value, std::is_pointer<T>{});
+    }
+    QS_CONSTEXPR14 typename std::conditional<std::is_pointer<T>::value, T, T const*>::type
+    operator->() const noexcept
+    {
+        return arrow_(storage::value, std::is_pointer<T>{});
+    }
+
+    QS_CONSTEXPR14 operator T&() noexcept { return storage::value; }
+    QS_CONSTEXPR14 operator T const&() const noexcept { return storage::value; }
+
+    using tracker::get_counters;
+    using tracker::get_enabled_events;
+    using tracker::get_heavy_counters;
+    using tracker::get_leak_stacks;
+    using tracker::get_missed_moves;
+    using tracker::get_move_quality;
+    using tracker::get_overhead;
+#if QS_LIFECYCLE_TRACKER_PERF
+    using tracker::get_perf_counters;
+#endif
+    using tracker::get_sink;
+    using tracker::get_type_name;
+    using tracker::is_event_enabled;
+    using tracker::print_counters;
+    using tracker::print_leaks;
+    using tracker::print_missed_moves;
+    using tracker::print_move_quality;
+    using tracker::reset_counters;
+    using tracker::reset_sink;
+    using tracker::set_enabled_events;
+    using tracker::set_event_enabled;
+    using tracker::set_leak_stacks_enabled;
+    using tracker::set_log_filter;
+    using tracker::set_missed_moves_enabled;
+    using tracker::set_move_quality_enabled;
+    using tracker::set_overhead_timing_enabled;
+#if QS_LIFECYCLE_TRACKER_PERF
+    using tracker::set_perf_counters_enabled;
+#endif
+    using tracker::set_sink;
+    using tracker::set_tracking_enabled;
+    using tracker::set_type_name;
+    using tracker::set_watchdog;
+    using tracker::subscribe;
+
+private:
+    template<class U>
+    static QS_CONSTEXPR14 U arrow_(U value, std::true_type) noexcept
+    {
+        return value;
+    }
+
+    template<class U>
+    static QS_CONSTEXPR14 U* arrow_(U& value, std::false_type) noexcept
+    {
+        return std::addressof(value);
+    }
+};
+
+// qs::tracked with multi-threading support
+template<class T, size_t Uuid>
+class tracked_mt
+    : public intl::lifecycle_perf_probe<tracked_mt<T, Uuid>, T,
+                                        intl::lifecycle_tracker_mt_base<tracked_mt<T, Uuid>, T, Uuid>>,
+      private intl::lifecycle_tracked_storage<T>,
+      public intl::lifecycle_tracker_mt_base<tracked_mt<T, Uuid>, T, Uuid>
+{
+    using storage = intl::lifecycle_tracked_storage<T>;
+    using tracker = intl::lifecycle_tracker_mt_base<tracked_mt<T, Uuid>, T, Uuid>;
+
+public:
+    using value_type = T;
+    using pointer    = typename std::conditional<std::is_pointer<T>::value, T, T*>::type;
+
+    // Value-initialize T
+    QS_CONSTEXPR20 tracked_mt()
+        : storage()
+    {}
+
+    // Copy or move value into T
+    QS_CONSTEXPR20 tracked_mt(T const& value)
+        : storage(value)
+    {}
+    QS_CONSTEXPR20 tracked_mt(T&& value)
+        : storage(std::move(value))
+    {}
+
+    // Construct T from two or more arguments
+    template<class Arg0, class Arg1, class... Args>
+    QS_CONSTEXPR20 tracked_mt(Arg0&& arg0, Arg1&& arg1, Args&&... args)
+        : storage(std::forward<Arg0>(arg0), std::forward<Arg1>(arg1), std::forward<Args>(args)...)
+    {}
+#if QS_LIFECYCLE_TRACKER_CONSTEXPR
+
+    // Construct with T(args...) and count the events of this object, and of the copies and moves
+    // made from it, in `context` during constant evaluation
+    template<class... Args>
+    constexpr tracked_mt(lifecycle_constexpr_context& context, Args&&... args)
+        : storage(std::forward<Args>(args)...), tracker(context)
+    {}
+#endif
+
+    // Access the held T
+    QS_CONSTEXPR14 T&       get() noexcept { return storage::value; }
+    QS_CONSTEXPR14 T const& get() const noexcept { return storage::value; }
+
+    QS_CONSTEXPR14 T&       operator*() noexcept { return storage::value; }
+    QS_CONSTEXPR14 T const& operator*() const noexcept { return storage::value; }
+
+    // The held pointer when T is a pointer, the address of T otherwise
+    QS_CONSTEXPR14 pointer operator->() noexcept
+    {
+        return arrow_(storage::value, std::is_pointer<T>{});
+    }
+    QS_CONSTEXPR14 typename std::conditional<std::is_pointer<T>::value, T, T const*>::type
+    operator->() const noexcept
+    {
+        return arrow_(storage::value, std::is_pointer<T>{});
+    }
+
+    QS_CONSTEXPR14 operator T&() noexcept { return storage::value; }
+    QS_CONSTEXPR14 operator T const&() const noexcept { return storage::value; }
+
     using tracker::get_counters;
+    using tracker::get_cross_thread_destructions;
+    using tracker::get_enabled_events;
+    using tracker::get_heavy_counters;
+    using tracker::get_leak_stacks;
+    using tracker::get_missed_moves;
+    using tracker::get_move_quality;
+    using tracker::get_overhead;
+#if QS_LIFECYCLE_TRACKER_PERF
+    using tracker::get_perf_counters;
+#endif
+    using tracker::get_sink;
+    using tracker::get_task_counters;
+    using tracker::get_thread_counters;
     using tracker::get_type_name;
+    using tracker::is_event_enabled;
     using tracker::print_counters;
+    using tracker::print_cross_thread_destructions;
+    using tracker::print_leaks;
+    using tracker::print_missed_moves;
+    using tracker::print_move_quality;
     using tracker::reset_counters;
+    using tracker::reset_sink;
+    using tracker::set_cross_thread_enabled;
+    using tracker::set_enabled_events;
+    using tracker::set_event_enabled;
+    using tracker::set_leak_stacks_enabled;
+    using tracker::set_log_filter;
+    using tracker::set_missed_moves_enabled;
+    using tracker::set_move_quality_enabled;
+    using tracker::set_overhead_timing_enabled;
+#if QS_LIFECYCLE_TRACKER_PERF
+    using tracker::set_perf_counters_enabled;
+#endif
+    using tracker::set_sink;
+    using tracker::set_task_counters_enabled;
+    using tracker::set_thread_counters_enabled;
+    using tracker::set_tracking_enabled;
     using tracker::set_type_name;
+    using tracker::set_watchdog;
+    using tracker::subscribe;
+
+private:
+    template<class U>
+    static QS_CONSTEXPR14 U arrow_(U value, std::true_type) noexcept
+    {
+        return value;
+    }
+
+    template<class U>
+    static QS_CONSTEXPR14 U* arrow_(U& value, std::false_type) noexcept
+    {
+        return std::addressof(value);
+    }
 };
 
 
 QS_NAMESPACE_END
 
 
-#if QS_LIFECYCLE_TRACKER_WITH_FMTLIB
+#if (QS_LIFECYCLE_DECLARE_ONLY || QS_LIFECYCLE_TRACKER_FORMAT != 1) && !defined(FMT_VERSION)
+// fmt is not included, formatters are only provided when it is included before this header
+#elif QS_LIFECYCLE_TRACKER_WITH_FMTLIB
 
 template<class T, size_t Uuid>
 struct fmt::formatter<qs::lifecycle_tracker<T, Uuid>> : fmt::formatter<T>
@@ -1020,7 +6746,27 @@ template<class T, size_t Uuid>
 struct fmt::formatter<qs::lifecycle_tracker_mt<T, Uuid>> : fmt::formatter<T>
 {};
 
-#elif defined(__cpp_lib_print)
+template<class T, size_t Uuid>
+struct fmt::formatter<qs::tracked<T, Uuid>> : fmt::formatter<T>
+{
+    template<class FormatContext>
+    auto format(qs::tracked<T, Uuid> const& value, FormatContext& ctx) const -> decltype(ctx.out())
+    {
+        return fmt::formatter<T>::format(*value, ctx);
+    }
+};
+
+template<class T, size_t Uuid>
+struct fmt::formatter<qs::tracked_mt<T, Uuid>> : fmt::formatter<T>
+{
+    template<class FormatContext>
+    auto format(qs::tracked_mt<T, Uuid> const& value, FormatContext& ctx) const -> decltype(ctx.out())
+    {
+        return fmt::formatter<T>::format(*value, ctx);
+    }
+};
+
+#elif defined(__cpp_lib_print) && QS_LIFECYCLE_TRACKER_FORMAT == 2
 
 template<class T, size_t Uuid>
 struct std::formatter<qs::lifecycle_tracker<T, Uuid>> : std::formatter<T>
@@ -1030,11 +6776,36 @@ template<class T, size_t Uuid>
 struct std::formatter<qs::lifecycle_tracker_mt<T, Uuid>> : std::formatter<T>
 {};
 
+template<class T, size_t Uuid>
+struct std::formatter<qs::tracked<T, Uuid>> : std::formatter<T>
+{
+    template<class FormatContext>
+    auto format(qs::tracked<T, Uuid> const& value, FormatContext& ctx) const -> decltype(ctx.out())
+    {
+        return std::formatter<T>::format(*value, ctx);
+    }
+};
+
+template<class T, size_t Uuid>
+struct std::formatter<qs::tracked_mt<T, Uuid>> : std::formatter<T>
+{
+    template<class FormatContext>
+    auto format(qs::tracked_mt<T, Uuid> const& value, FormatContext& ctx) const -> decltype(ctx.out())
+    {
+        return std::formatter<T>::format(*value, ctx);
+    }
+};
+
 #endif
 
 
-#undef QS_LIFECYCLE_LOGGER_PRINT
+#undef QS_LIFECYCLE_LOGGER_FORMAT_TO
 #undef QS_LIFECYCLE_LOGGER_STRING_ARG
+#undef QS_LIFECYCLE_DECLARE_ONLY
+#undef QS_LIFECYCLE_API
+#undef QS_LIFECYCLE_ABI
+#undef QS_LIFECYCLE_ABI_CAT
+#undef QS_LIFECYCLE_ABI_CAT_
 
 
 #endif // QS_LIFECYCLE_TRACKER_SINGLE_HEADER_H
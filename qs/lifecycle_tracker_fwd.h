@@ -0,0 +1,67 @@
+// MIT License
+
+// Copyright (c) 2025 Jose Sa
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#ifndef QS_LIFECYCLE_TRACKER_FWD_H
+#define QS_LIFECYCLE_TRACKER_FWD_H
+
+
+// Forward declarations of the trackers, for headers that only name tracked types. Only the
+// translation units that construct or inspect them need qs/lifecycle_tracker.h.
+//
+//     struct Widget;
+//     using tracked_widget = qs::lifecycle_tracker<Widget>;
+//     std::unique_ptr<tracked_widget> make_widget();
+
+#include <cstddef>
+
+
+namespace qs
+{
+    enum class lifecycle_event;
+
+    struct lifecycle_counters;
+
+    class lifecycle_sink;
+
+    template<class T, std::size_t Uuid = 0>
+    struct lifecycle_logger;
+
+    template<class T, std::size_t Uuid = 0>
+    struct lifecycle_log_filter;
+
+    template<class T, std::size_t Uuid = 0>
+    class lifecycle_tracker;
+
+    template<class T, std::size_t Uuid = 0>
+    class lifecycle_tracker_mt;
+
+    template<class T, std::size_t Uuid = 0>
+    class tracked;
+
+    template<class T, std::size_t Uuid = 0>
+    class tracked_mt;
+} // namespace qs
+
+
+#endif // QS_LIFECYCLE_TRACKER_FWD_H
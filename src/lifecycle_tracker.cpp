@@ -0,0 +1,34 @@
+// MIT License
+
+// Copyright (c) 2025 Jose Sa
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+// Out-of-line formatting and demangling for QS_LIFECYCLE_TRACKER_COMPILED. This is the only
+// translation unit that includes fmt, <format> or <cxxabi.h> on behalf of the trackers. It also
+// defines the sinks, the registry and the feature tables declared under QS_LIFECYCLE_DECLARE_ONLY.
+
+#ifndef QS_LIFECYCLE_TRACKER_COMPILED
+#define QS_LIFECYCLE_TRACKER_COMPILED 1
+#endif
+#define QS_LIFECYCLE_TRACKER_COMPILED_IMPL
+
+#include <qs/lifecycle_tracker.h>
@@ -0,0 +1,24 @@
+# Fails when the inlined code of a tracked copy grows past LIMIT bytes over the plain copy.
+# Usage: cmake -DNM=<nm> -DOBJECTS=<objects> -DLIMIT=<bytes> -P check_codesize.cmake
+
+execute_process(COMMAND ${NM} -S --defined-only ${OBJECTS}
+                OUTPUT_VARIABLE symbols
+                RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${NM} failed on ${OBJECTS}")
+endif()
+
+foreach(kind plain tracked)
+    string(REGEX MATCH "[0-9a-fA-F]+ ([0-9a-fA-F]+) [Tt] _?lifecycle_codesize_${kind}\n" match
+           "${symbols}")
+    if(NOT match)
+        message(FATAL_ERROR "lifecycle_codesize_${kind} not found in ${OBJECTS}")
+    endif()
+    math(EXPR size_${kind} "0x${CMAKE_MATCH_1}")
+endforeach()
+
+math(EXPR overhead "${size_tracked} - ${size_plain}")
+message(STATUS "plain copy: ${size_plain} bytes, tracked copy: ${size_tracked} bytes")
+if(overhead GREATER LIMIT)
+    message(FATAL_ERROR "tracked copy inlines ${overhead} bytes, more than the ${LIMIT} allowed")
+endif()
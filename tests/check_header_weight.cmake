@@ -0,0 +1,16 @@
+# Fails when the preprocessed TRACKED translation unit has more lines than the BASELINE one.
+# Usage: cmake -DTRACKED=<preprocessed> -DBASELINE=<preprocessed> -P check_header_weight.cmake
+
+foreach(kind TRACKED BASELINE)
+    if(NOT EXISTS "${${kind}}")
+        message(FATAL_ERROR "${${kind}} not found")
+    endif()
+    file(STRINGS "${${kind}}" lines)
+    list(LENGTH lines lines_${kind})
+endforeach()
+
+message(STATUS "baseline: ${lines_BASELINE} lines, compiled tracker: ${lines_TRACKED} lines")
+if(lines_TRACKED GREATER lines_BASELINE)
+    message(FATAL_ERROR "a compiled tracker preprocesses to ${lines_TRACKED} lines, "
+                        "more than the ${lines_BASELINE} of the header-only baseline")
+endif()
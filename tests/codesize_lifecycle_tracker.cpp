@@ -0,0 +1,25 @@
+// Copies of a plain and of a tracked type, compiled with optimizations. check_codesize.cmake
+// compares the size of the two functions to bound the code inlined by the tracker.
+
+#include <qs/lifecycle_tracker.h>
+
+#include <new>
+
+
+struct Plain
+{
+    int v;
+};
+
+using Tracked = qs::lifecycle_tracker<Plain>;
+
+
+extern "C" void lifecycle_codesize_plain(Plain* out, Plain const* in)
+{
+    ::new(static_cast<void*>(out)) Plain{*in};
+}
+
+extern "C" void lifecycle_codesize_tracked(Tracked* out, Tracked const* in)
+{
+    ::new(static_cast<void*>(out)) Tracked{*in};
+}
@@ -1,9 +1,19 @@
 #include <gmock/gmock.h>
+#include <gtest/gtest-spi.h>
 
+#include <qs/lifecycle_baseline.h>
+#include <qs/lifecycle_containers.h>
+#include <qs/lifecycle_gtest.h>
+#include <qs/lifecycle_trace.h>
 #include <qs/lifecycle_tracker.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
 #include <type_traits>
 #include <string>
+#include <thread>
 #include <vector>
 
 
@@ -216,3 +226,1209 @@ TEST(LifetimeTrackerMt, StdString)
 
     //qs::lifecycle_tracker<int>::print_counters();
 }
+
+
+struct Gadget
+{
+    Gadget(int id)
+        : id{id} {};
+    int id{};
+};
+
+TEST(LifecycleSink, RingSinkPerType)
+{
+    using tracker = qs::lifecycle_tracker<Gadget, 1>;
+    tracker::set_type_name("Gadget");
+    qs::lifecycle_sinks::set_batch_size(4096);
+
+    qs::lifecycle_ring_sink ring{256};
+    tracker::set_sink(&ring);
+    EXPECT_EQ(tracker::get_sink(), &ring);
+    {
+        tracker a{1};
+        tracker b{a};
+        b = std::move(a);
+    }
+    EXPECT_EQ(ring.contents(), ""); // still batched in the thread buffer
+
+    qs::lifecycle_sinks::flush();
+    std::string const logged = "Gadget(...)\nGadget(Gadget const&)\n=(Gadget&&)\n~Gadget()\n~Gadget()\n";
+    EXPECT_EQ(ring.contents(), logged);
+
+    tracker::set_sink(nullptr);
+    EXPECT_EQ(tracker::get_sink(), nullptr);
+    {
+        tracker c{2};
+    }
+    qs::lifecycle_sinks::flush();
+    EXPECT_EQ(ring.contents(), logged);
+
+    tracker::reset_sink();
+    EXPECT_EQ(tracker::get_sink(), qs::lifecycle_sinks::get_default());
+    qs::lifecycle_sinks::set_batch_size(QS_LIFECYCLE_SINK_BATCH_SIZE);
+}
+
+TEST(LifecycleSink, ConfigureFromSpec)
+{
+    using tracker = qs::lifecycle_tracker<Gadget, 2>;
+    tracker::set_type_name("Gadget2");
+
+    qs::lifecycle_sink* const previous = qs::lifecycle_sinks::get_default();
+    ASSERT_TRUE(qs::lifecycle_sinks::configure("ring:64;Gadget2=null"));
+    EXPECT_EQ(tracker::get_sink(), nullptr);
+
+    auto* const ring = dynamic_cast<qs::lifecycle_ring_sink*>(qs::lifecycle_sinks::get_default());
+    ASSERT_NE(ring, nullptr);
+    qs::lifecycle_sinks::set_batch_size(0);
+    {
+        qs::lifecycle_tracker<Gadget, 3> g{3};
+        EXPECT_EQ(ring->contents(), "Gadget(...)\n");
+    }
+    EXPECT_EQ(ring->contents(), "Gadget(...)\n~Gadget()\n");
+    qs::lifecycle_sinks::flush();
+
+    EXPECT_FALSE(qs::lifecycle_sinks::configure("bogus"));
+    qs::lifecycle_sinks::set_default(previous);
+    qs::lifecycle_sinks::set_batch_size(QS_LIFECYCLE_SINK_BATCH_SIZE);
+}
+
+TEST(LifecycleSink, ConfigureAfterMutingType)
+{
+    using tracker = qs::lifecycle_tracker<Gadget, 22>;
+    tracker::set_type_name("Gadget22");
+    tracker::set_sink(nullptr);
+
+    qs::lifecycle_sink* const previous = qs::lifecycle_sinks::get_default();
+    ASSERT_TRUE(qs::lifecycle_sinks::configure("ring:64"));
+    auto* const ring = dynamic_cast<qs::lifecycle_ring_sink*>(qs::lifecycle_sinks::get_default());
+    ASSERT_NE(ring, nullptr);
+    EXPECT_EQ(tracker::get_sink(), ring);
+    {
+        tracker g{22};
+    }
+    qs::lifecycle_sinks::flush();
+    EXPECT_EQ(ring->contents(), "Gadget22(...)\n~Gadget22()\n");
+
+    // a null default sink mutes the types that inherit it
+    qs::lifecycle_sinks::set_default(nullptr);
+    EXPECT_EQ(tracker::get_sink(), nullptr);
+    {
+        tracker g{23};
+    }
+    qs::lifecycle_sinks::flush();
+    EXPECT_EQ(ring->contents(), "Gadget22(...)\n~Gadget22()\n");
+    qs::lifecycle_sinks::set_default(previous);
+}
+
+
+TEST(LifetimeTrackerMt, RuntimeSwitches)
+{
+    using tracker = qs::lifecycle_tracker_mt<Gadget, 4>;
+    tracker::set_sink(nullptr);
+    EXPECT_EQ(tracker::get_enabled_events(), qs::lifecycle_all_events);
+
+    tracker::set_tracking_enabled(false);
+    {
+        tracker a{1};
+        tracker b{a};
+    }
+    EXPECT_EQ(tracker::get_counters(), (qs::lifecycle_counters{0, 0, 0, 0, 0, 0}));
+
+    tracker::set_event_enabled(qs::lifecycle_event::CopyConstructor, true);
+    EXPECT_TRUE(tracker::is_event_enabled(qs::lifecycle_event::CopyConstructor));
+    EXPECT_FALSE(tracker::is_event_enabled(qs::lifecycle_event::Destructor));
+    {
+        tracker a{1};
+        tracker b{a};
+        tracker c{std::move(b)};
+    }
+    EXPECT_EQ(tracker::get_counters(), (qs::lifecycle_counters{0, 1, 0, 0, 0, 0}));
+
+    tracker::set_tracking_enabled(true);
+    tracker::set_event_enabled(qs::lifecycle_event::Destructor, false);
+    {
+        tracker a{1};
+    }
+    EXPECT_EQ(tracker::get_counters(), (qs::lifecycle_counters{1, 1, 0, 0, 0, 0}));
+    tracker::set_enabled_events(qs::lifecycle_all_events);
+}
+
+
+TEST(LifetimeTracker, LeakStacks)
+{
+    using tracker = qs::lifecycle_tracker<Gadget, 5>;
+    tracker::set_sink(nullptr);
+    tracker::set_leak_stacks_enabled(true);
+
+    std::vector<tracker*> leaked;
+    for(int i = 0; i < 3; ++i)
+        leaked.push_back(new tracker{i});
+    {
+        tracker temporary{7};
+        tracker copy{temporary};
+    }
+    tracker* const other = new tracker{*leaked.front()};
+
+    std::vector<qs::lifecycle_leak_stack> const stacks = tracker::get_leak_stacks();
+    ASSERT_EQ(stacks.size(), 2u);
+    EXPECT_EQ(stacks[0].alive, 3u);
+    EXPECT_EQ(stacks[1].alive, 1u);
+    EXPECT_NE(stacks[0].frames, stacks[1].frames);
+
+    qs::lifecycle_ring_sink ring;
+    tracker::print_leaks(1, &ring);
+    EXPECT_THAT(ring.contents(), ::testing::StartsWith("Lifecycle leaks [type: Gadget, uuid: 5]: 4 alive\n"
+                                                       " * 3 alive, constructed at:\n"));
+
+    for(tracker* t : leaked)
+        delete t;
+    delete other;
+    EXPECT_TRUE(tracker::get_leak_stacks().empty());
+    tracker::set_leak_stacks_enabled(false);
+}
+
+
+TEST(LifecycleBaseline, DumpRoundTrip)
+{
+    using tracker = qs::lifecycle_tracker<Gadget, 6>;
+    tracker::set_sink(nullptr);
+    {
+        tracker a{1};
+        tracker b{a};
+        b = a;
+    }
+
+    std::vector<qs::lifecycle_baseline_entry> entries;
+    ASSERT_TRUE(qs::lifecycle_baseline::parse(qs::lifecycle_registry::to_json(), entries));
+    auto const it = std::find_if(entries.begin(), entries.end(),
+                                 [](qs::lifecycle_baseline_entry const& e) { return e.uuid == 6; });
+    ASSERT_NE(it, entries.end());
+    EXPECT_EQ(it->key(), "Gadget#6");
+    EXPECT_EQ(it->counters, (qs::lifecycle_counters{1, 1, 0, 1, 0, 2}));
+
+    EXPECT_FALSE(qs::lifecycle_baseline::parse("{\"types\": [", entries));
+}
+
+
+TEST(LifecycleBaseline, CompareThresholds)
+{
+    std::vector<qs::lifecycle_baseline_entry> baseline, current;
+    ASSERT_TRUE(qs::lifecycle_baseline::parse(
+        R"({"version": 1, "types": [{"name": "A", "uuid": 0, "mt": false, "constructor": 10,
+            "copy_constructor": 4, "alive": -1}, {"name": "B", "uuid": 0, "mt": true}]})",
+        baseline));
+    ASSERT_TRUE(qs::lifecycle_baseline::parse(
+        R"({"version": 1, "types": [{"name": "A", "uuid": 0, "mt": false, "constructor": 11,
+            "copy_constructor": 9, "destructor": 50}, {"name": "C", "uuid": 0, "mt": false,
+            "constructor": 99}]})",
+        current));
+
+    auto regressions = qs::lifecycle_baseline::compare(baseline, current);
+    ASSERT_EQ(regressions.size(), 3u);
+    EXPECT_EQ(regressions[0].key, "A#0");
+    EXPECT_EQ(regressions[0].event, qs::lifecycle_event::Constructor);
+    EXPECT_EQ(regressions[1].event, qs::lifecycle_event::CopyConstructor);
+    EXPECT_EQ(regressions[1].baseline, 4u);
+    EXPECT_EQ(regressions[1].current, 9u);
+    EXPECT_FALSE(regressions[1].new_type);
+    // C is missing from the baseline
+    EXPECT_EQ(regressions[2].key, "C#0");
+    EXPECT_EQ(regressions[2].baseline, 0u);
+    EXPECT_EQ(regressions[2].current, 99u);
+    EXPECT_TRUE(regressions[2].new_type);
+
+    qs::lifecycle_compare_options options{};
+    options.max_ratio        = 0.2;
+    options.min_delta        = 1;
+    options.ignore_new_types = true;
+    regressions              = qs::lifecycle_baseline::compare(baseline, current, options);
+    ASSERT_EQ(regressions.size(), 1u);
+    EXPECT_EQ(regressions[0].event, qs::lifecycle_event::CopyConstructor);
+}
+
+
+TEST(LifetimeTrackerMt, ThreadCounters)
+{
+    using tracker = qs::lifecycle_tracker_mt<Gadget, 7>;
+    tracker::set_sink(nullptr);
+    tracker::set_thread_counters_enabled(true);
+    qs::lifecycle_threads::set_name("main");
+
+    tracker const first{1};
+    std::vector<tracker> made;
+    std::thread{[&made] {
+        qs::lifecycle_threads::set_name("io");
+        made.emplace_back(2);
+        made.emplace_back(3);
+    }}.join();
+    made.clear();
+
+    std::vector<qs::lifecycle_thread_counters> const threads = tracker::get_thread_counters();
+    ASSERT_EQ(threads.size(), 2u);
+    EXPECT_EQ(threads[0].thread, "main");
+    EXPECT_EQ(threads[0].counters, (qs::lifecycle_counters{1, 0, 0, 0, 0, 2}));
+    EXPECT_EQ(threads[1].thread, "retired");
+    EXPECT_EQ(threads[1].counters, (qs::lifecycle_counters{2, 0, 1, 0, 0, 1}));
+
+    tracker::reset_counters();
+    EXPECT_EQ(tracker::get_thread_counters()[0].counters, (qs::lifecycle_counters{}));
+    tracker::set_thread_counters_enabled(false);
+}
+
+
+TEST(LifetimeTrackerMt, ThreadCountersAfterThreadExit)
+{
+    using tracker = qs::lifecycle_tracker_mt<Gadget, 9>;
+    tracker::set_sink(nullptr);
+    tracker::set_thread_counters_enabled(true);
+    tracker::reset_counters();
+
+    // destroyed after the record of the thread, which is created by the first event
+    std::thread{[] {
+        thread_local std::vector<tracker> kept;
+        kept.reserve(1);
+        kept.emplace_back(1);
+    }}.join();
+
+    std::vector<qs::lifecycle_thread_counters> const threads = tracker::get_thread_counters();
+    ASSERT_FALSE(threads.empty());
+    EXPECT_EQ(threads.back().thread, "retired");
+    EXPECT_EQ(threads.back().counters, (qs::lifecycle_counters{1, 0, 0, 0, 0, 1}));
+    tracker::set_thread_counters_enabled(false);
+}
+
+
+TEST(LifetimeTrackerMt, CrossThreadDestructions)
+{
+    using tracker = qs::lifecycle_tracker_mt<Gadget, 8>;
+    tracker::set_sink(nullptr);
+    tracker::set_cross_thread_enabled(true);
+    qs::lifecycle_threads::set_name("main");
+
+    std::vector<tracker> made;
+    made.reserve(4);
+    std::thread{[&made] {
+        qs::lifecycle_threads::set_name("producer");
+        made.emplace_back(1);
+        made.emplace_back(2);
+    }}.join();
+    made.emplace_back(3);
+    made.clear();
+
+    std::vector<qs::lifecycle_thread_pair> const pairs = tracker::get_cross_thread_destructions();
+    ASSERT_EQ(pairs.size(), 1u);
+    EXPECT_EQ(pairs[0].creator, "producer");
+    EXPECT_EQ(pairs[0].destroyer, "main");
+    EXPECT_EQ(pairs[0].count, 2u);
+
+    qs::lifecycle_ring_sink ring;
+    tracker::print_cross_thread_destructions(&ring);
+    EXPECT_EQ(ring.contents(), "Lifecycle cross-thread destructions [type: Gadget, uuid: 8]: 2\n"
+                               " * producer -> main : 2\n");
+    tracker::set_cross_thread_enabled(false);
+}
+
+
+TEST(LifetimeTracker, MissedMoves)
+{
+    using tracker = qs::lifecycle_tracker<Gadget, 9>;
+    tracker::set_sink(nullptr);
+    tracker::set_missed_moves_enabled(true);
+
+    std::vector<tracker> kept;
+    kept.reserve(4);
+    {
+        tracker local{1};
+        kept.push_back(local);
+    }
+    tracker const alive{2};
+    kept.push_back(alive);
+    {
+        tracker source{3};
+        tracker target{4};
+        target = source;
+    }
+
+    std::vector<qs::lifecycle_missed_move> const sites = tracker::get_missed_moves();
+    ASSERT_EQ(sites.size(), 2u);
+    EXPECT_EQ(sites[0].count + sites[1].count, 2u);
+    EXPECT_NE(sites[0].event, sites[1].event);
+
+    qs::lifecycle_ring_sink ring;
+    tracker::print_missed_moves(1, &ring);
+    EXPECT_THAT(ring.contents(), ::testing::StartsWith("Lifecycle missed moves [type: Gadget, uuid: 9]: 2\n"
+                                                       " * 1 copy "));
+    tracker::set_missed_moves_enabled(false);
+    EXPECT_TRUE(tracker::get_missed_moves().empty());
+}
+
+
+TEST(LifecycleSubscribers, TypeAndGlobalCallbacks)
+{
+    using tracker = qs::lifecycle_tracker<Gadget, 10>;
+    tracker::set_sink(nullptr);
+
+    std::vector<qs::lifecycle_event> type_events;
+    std::vector<void const*>         objects;
+    size_t                           global_events = 0;
+    qs::lifecycle_subscription       by_type       = tracker::subscribe(
+        [&type_events, &objects](qs::lifecycle_event_info const& info)
+        {
+            EXPECT_EQ(info.type_name, "Gadget");
+            EXPECT_EQ(info.uuid, 10u);
+            EXPECT_FALSE(info.mt);
+            type_events.push_back(info.event);
+            objects.push_back(info.object);
+        });
+    qs::lifecycle_subscription everything = qs::lifecycle_subscribers::subscribe(
+        [&global_events](qs::lifecycle_event_info const& info)
+        {
+            if(info.uuid == 10)
+                ++global_events;
+        });
+    {
+        tracker       a{1};
+        tracker const b{a};
+        EXPECT_EQ(objects[0], static_cast<Gadget const*>(&a));
+        EXPECT_EQ(objects[1], static_cast<Gadget const*>(&b));
+    }
+    EXPECT_THAT(type_events, ::testing::ElementsAre(qs::lifecycle_event::Constructor,
+                                                    qs::lifecycle_event::CopyConstructor,
+                                                    qs::lifecycle_event::Destructor,
+                                                    qs::lifecycle_event::Destructor));
+    EXPECT_EQ(global_events, 4u);
+
+    by_type.unsubscribe();
+    EXPECT_FALSE(by_type);
+    {
+        tracker const c{2};
+    }
+    EXPECT_EQ(type_events.size(), 4u);
+    EXPECT_EQ(global_events, 6u);
+
+    everything = qs::lifecycle_subscription{};
+    EXPECT_TRUE(qs::lifecycle_subscribers::empty());
+    {
+        tracker const d{3};
+    }
+    EXPECT_EQ(global_events, 6u);
+}
+
+
+TEST(LifecycleSubscribers, ConcurrentSubscriptions)
+{
+    using tracker = qs::lifecycle_tracker_mt<Gadget, 10>;
+    tracker::set_sink(nullptr);
+
+    std::atomic<size_t>        seen{0};
+    qs::lifecycle_subscription counting =
+        tracker::subscribe([&seen](qs::lifecycle_event_info const&) { ++seen; });
+
+    std::vector<std::thread> threads;
+    for(int t = 0; t < 4; ++t)
+        threads.emplace_back(
+            []
+            {
+                for(int i = 0; i < 1000; ++i)
+                {
+                    qs::lifecycle_subscription const churn =
+                        tracker::subscribe([](qs::lifecycle_event_info const&) {});
+                    tracker const g{i};
+                }
+            });
+    for(std::thread& thread : threads)
+        thread.join();
+
+    EXPECT_EQ(seen.load(), 8000u);
+}
+
+
+TEST(LifecycleSubscribers, FreesReplacedListsUnderConstantLoad)
+{
+    using tracker = qs::lifecycle_tracker_mt<Gadget, 13>;
+    tracker::set_sink(nullptr);
+
+    std::atomic<bool>          stop{false};
+    qs::lifecycle_subscription reading = tracker::subscribe([](qs::lifecycle_event_info const&) {});
+    std::thread                events{[&stop]
+                                      {
+                                          while(!stop.load())
+                                              tracker const g{1};
+                                      }};
+
+    auto                     owner = std::make_shared<int>(0);
+    std::weak_ptr<int> const held  = owner;
+    tracker::subscribe([owner](qs::lifecycle_event_info const&) {}).unsubscribe();
+    owner.reset();
+    for(int i = 0; i < 100; ++i)
+        tracker::subscribe([](qs::lifecycle_event_info const&) {}).unsubscribe();
+    stop = true;
+    events.join();
+    // the list that held the callback is retired, and freed by the first change without a reader
+    tracker::subscribe([](qs::lifecycle_event_info const&) {}).unsubscribe();
+    EXPECT_TRUE(held.expired());
+}
+
+
+TEST(LifetimeTrackerMt, TaskCounters)
+{
+    using tracker = qs::lifecycle_tracker_mt<Gadget, 11>;
+    tracker::set_sink(nullptr);
+    tracker::set_task_counters_enabled(true);
+
+    qs::lifecycle_task_context const get = qs::lifecycle_task_context::start("GET");
+    {
+        qs::lifecycle_task_scope const scope{get};
+        EXPECT_EQ(qs::lifecycle_task_context::current(), get);
+        tracker const a{1};
+        tracker const b{a};
+    }
+    EXPECT_FALSE(qs::lifecycle_task_context::current());
+    {
+        qs::lifecycle_task_scope const scope{qs::lifecycle_task_context::start("GET")};
+        tracker const                  d{2};
+        tracker const                  copy{d};
+    }
+    {
+        qs::lifecycle_task_scope const scope{qs::lifecycle_task_context::start("POST")};
+        tracker const                  e{3};
+    }
+    tracker const outside{4};
+
+    std::vector<qs::lifecycle_task_counters> const tasks = tracker::get_task_counters();
+    ASSERT_EQ(tasks.size(), 2u);
+    EXPECT_EQ(tasks[0].task, "GET");
+    EXPECT_EQ(tasks[0].runs, 2u);
+    EXPECT_EQ(tasks[0].counters, (qs::lifecycle_counters{2, 2, 0, 0, 0, 4}));
+    EXPECT_EQ(tasks[1].task, "POST");
+    EXPECT_EQ(tasks[1].runs, 1u);
+    EXPECT_EQ(tasks[1].counters, (qs::lifecycle_counters{1, 0, 0, 0, 0, 1}));
+
+    tracker::reset_counters();
+    EXPECT_TRUE(tracker::get_task_counters().empty());
+    tracker::set_task_counters_enabled(false);
+}
+
+
+TEST(LifetimeTrackerMt, StressCounters)
+{
+    using tracker = qs::lifecycle_tracker_mt<Gadget, 12>;
+    tracker::set_sink(nullptr);
+
+    constexpr size_t rounds = 2000;
+    constexpr size_t kept   = 16;
+    for(size_t threads : {1u, 2u, 4u, 8u})
+    {
+        tracker::reset_counters();
+        std::vector<std::vector<tracker>> survivors(threads);
+        std::vector<std::thread>          workers;
+        for(size_t t = 0; t < threads; ++t)
+            workers.emplace_back(
+                [&survivors, t]
+                {
+                    std::vector<tracker>& mine = survivors[t];
+                    mine.reserve(kept);
+                    for(size_t i = 0; i < rounds; ++i)
+                    {
+                        tracker       a{static_cast<int>(i)};
+                        tracker       b{a};
+                        tracker const c{std::move(b)};
+                        a = c;
+                        b = std::move(a);
+                        if(i < kept)
+                            mine.push_back(std::move(b));
+                    }
+                });
+        for(std::thread& worker : workers)
+            worker.join();
+
+        size_t const                 n    = threads * rounds;
+        qs::lifecycle_counters const cnts = tracker::get_counters();
+        EXPECT_EQ(cnts.constructor, n) << threads << " threads";
+        EXPECT_EQ(cnts.copy_constructor, n) << threads << " threads";
+        EXPECT_EQ(cnts.move_constructor, n + threads * kept) << threads << " threads";
+        EXPECT_EQ(cnts.copy_assignment, n) << threads << " threads";
+        EXPECT_EQ(cnts.move_assignment, n) << threads << " threads";
+        EXPECT_EQ(cnts.alive(), threads * kept) << threads << " threads";
+        survivors.clear();
+        EXPECT_EQ(tracker::get_counters().alive(), 0u) << threads << " threads";
+    }
+}
+
+
+TEST(LifecycleContainers, VectorReallocations)
+{
+    using tracker = qs::lifecycle_tracker<Gadget, 13>;
+    tracker::set_type_name("Gadget");
+    tracker::set_sink(nullptr);
+    tracker::reset_counters();
+
+    qs::lifecycle_vector<tracker> v;
+    for(int i = 0; i < 5; ++i)
+        v.emplace_back(i);
+
+    // capacity grows 1 -> 2 -> 4 -> 8, relocating 1 + 2 + 4 elements; the tracker move
+    // constructor is not noexcept, so std::vector copies them
+    qs::lifecycle_container_stats const stats{3, 7, 0, 5, 8};
+    EXPECT_EQ(v.stats(), stats);
+    EXPECT_EQ(tracker::get_counters().copy_constructor, 7u);
+
+    qs::lifecycle_ring_sink ring;
+    v.print_stats(&ring);
+    EXPECT_THAT(ring.contents(), ::testing::StartsWith("Lifecycle vector [element: Gadget]\n"
+                                                       " * reallocations (copies/moves) : 3 (7/0)\n"
+                                                       " * peak size (capacity)         : 5 (8)\n"));
+    EXPECT_THAT(ring.contents(), ::testing::HasSubstr("uuid: 13"));
+
+    v.reset_stats();
+    v.reserve(5);
+    v.shrink_to_fit();
+    qs::lifecycle_container_stats const shrunk{1, 5, 0, 5, 8};
+    EXPECT_EQ(v.stats(), shrunk);
+}
+
+TEST(LifecycleContainers, DequeAndUnorderedMap)
+{
+    qs::lifecycle_deque<int> d;
+    for(int i = 0; i < 1000; ++i)
+        d.push_front(i);
+    EXPECT_EQ(d.stats().peak_size, 1000u);
+    EXPECT_GE(d.stats().peak_capacity, 1000u);
+    EXPECT_GT(d.stats().reallocations, 0u);
+    EXPECT_EQ(d.stats().relocated_copies + d.stats().relocated_moves, 0u);
+
+    qs::lifecycle_unordered_map<int, std::string> m;
+    for(int i = 0; i < 100; ++i)
+        m[i] = std::to_string(i);
+    EXPECT_EQ(m.stats().peak_size, 100u);
+    EXPECT_EQ(m.stats().peak_capacity, m.bucket_count());
+    EXPECT_GT(m.stats().reallocations, 0u);
+    EXPECT_EQ(m.stats().relocated_copies + m.stats().relocated_moves, 0u); // nodes are relinked
+}
+
+
+TEST(LifecycleContainers, MovedDequeKeepsItsBlocks)
+{
+    using gadget = qs::lifecycle_tracker<Gadget, 23>;
+    gadget::set_sink(nullptr);
+    gadget::reset_counters();
+
+    qs::lifecycle_deque<gadget> d;
+    for(int i = 0; i < 100; ++i)
+        d.emplace_back(i);
+    qs::lifecycle_deque<gadget> moved{std::move(d)};
+    d = std::move(moved);
+    EXPECT_EQ(d.size(), 100u);
+    EXPECT_EQ(d.stats().peak_size, 100u);
+    EXPECT_EQ(gadget::get_counters().copy_constructor, 0);
+    EXPECT_EQ(gadget::get_counters().move_constructor, 0);
+
+    qs::lifecycle_deque<std::unique_ptr<int>> owners;
+    owners.push_back(std::unique_ptr<int>{new int{1}});
+    qs::lifecycle_deque<std::unique_ptr<int>> other{std::move(owners)};
+    EXPECT_EQ(*other.front(), 1);
+    EXPECT_TRUE(owners.empty());
+}
+
+
+struct Sealed final
+{
+    Sealed(int a, int b)
+        : sum{a + b}
+    {}
+    int sum;
+};
+
+enum class Handle : int
+{
+    none,
+    first
+};
+
+static_assert(sizeof(qs::tracked<int>) == sizeof(int), "same size as a trivially copyable T");
+static_assert(sizeof(qs::tracked<Sealed*>) == sizeof(Sealed*), "same size as a pointer");
+static_assert(sizeof(qs::tracked_mt<Handle>) == sizeof(Handle), "same size as an enum");
+
+TEST(LifecycleTracked, ScalarPointerEnumAndFinal)
+{
+    using tracked_int = qs::tracked<int, 14>;
+    tracked_int::set_sink(nullptr);
+    tracked_int::reset_counters();
+    {
+        tracked_int a = 41;
+        tracked_int b{a};
+        b = std::move(a);
+        int& raw = b;
+        ++raw;
+        EXPECT_EQ(*b, 42);
+        EXPECT_EQ(b + 1, 43);
+        std::vector<tracked_int> values(3);
+        EXPECT_EQ(values[2].get(), 0); // value-initialized
+    }
+    qs::lifecycle_counters const cnts{4, 1, 0, 0, 1, 5};
+    EXPECT_EQ(tracked_int::get_counters(), cnts);
+    EXPECT_EQ(tracked_int::get_type_name(), "int");
+
+    using tracked_sealed = qs::tracked_mt<Sealed, 14>;
+    tracked_sealed::set_sink(nullptr);
+    tracked_sealed const sealed{2, 3};
+    tracked_sealed const copy  = sealed;
+    qs::tracked<Sealed const*, 14> ptr{&copy.get()};
+    EXPECT_EQ(ptr->sum, 5);
+    EXPECT_EQ(sealed->sum, 5);
+    EXPECT_EQ(tracked_sealed::get_counters().copy_constructor, 1u);
+
+    using tracked_handle = qs::tracked<Handle, 14>;
+    tracked_handle::set_sink(nullptr);
+    tracked_handle handle{Handle::first};
+    EXPECT_TRUE(handle == Handle::first);
+    EXPECT_EQ(tracked_handle::get_counters().constructor, 1u);
+}
+
+
+#if QS_LIFECYCLE_TRACKER_WITH_SIGNAL_DUMP
+TEST(LifecycleSignalDump, WritesParsableDumpFromHandler)
+{
+    using tracker = qs::lifecycle_tracker_mt<Gadget, 15>;
+    tracker::set_sink(nullptr);
+    tracker const a{1};
+    tracker const b{a};
+    {
+        tracker const outlived{0};
+        tracker::reset_counters();
+    }
+
+    int fds[2];
+    ASSERT_EQ(::pipe(fds), 0);
+    ASSERT_TRUE(qs::lifecycle_signal_dump::install(SIGUSR1, fds[1]));
+    ASSERT_EQ(::raise(SIGUSR1), 0);
+    EXPECT_TRUE(qs::lifecycle_signal_dump::uninstall(SIGUSR1));
+    ::close(fds[1]);
+
+    std::string json;
+    char        buffer[4096];
+    for(ssize_t n; (n = ::read(fds[0], buffer, sizeof(buffer))) > 0;)
+        json.append(buffer, static_cast<size_t>(n));
+    ::close(fds[0]);
+
+    std::vector<qs::lifecycle_baseline_entry> entries;
+    ASSERT_TRUE(qs::lifecycle_baseline::parse(json, entries)) << json;
+    auto const found = std::find_if(entries.begin(), entries.end(),
+                                    [](qs::lifecycle_baseline_entry const& entry)
+                                    { return entry.uuid == 15 && entry.mt; });
+    ASSERT_NE(found, entries.end()) << json;
+    EXPECT_EQ(found->name, typeid(Gadget).name());
+    qs::lifecycle_counters const cnts{0, 0, 0, 0, 0, 1};
+    EXPECT_EQ(found->counters, cnts);
+    // destroyed after the reset, so more destructions than constructions
+    EXPECT_THAT(json, ::testing::HasSubstr("\"destructor\": 1, \"alive\": -1}"));
+}
+#endif
+
+
+TEST(LifecycleCounterContext, ParallelIsolatedCounts)
+{
+    using tracker    = qs::lifecycle_tracker<Gadget, 16>;
+    using tracker_mt = qs::lifecycle_tracker_mt<Gadget, 16>;
+    tracker::set_sink(nullptr);
+    tracker_mt::set_sink(nullptr);
+    tracker::reset_counters();
+    tracker_mt::reset_counters();
+
+    std::atomic<size_t>      mismatches{0};
+    std::vector<std::thread> workers;
+    for(size_t t = 0; t < 4; ++t)
+        workers.emplace_back(
+            [t, &mismatches]
+            {
+                qs::lifecycle_counter_context     ctx;
+                qs::lifecycle_counter_scope const scope{ctx};
+                for(size_t round = 0; round < 200; ++round)
+                {
+                    tracker::reset_counters();
+                    tracker_mt::reset_counters();
+                    {
+                        tracker const        a{1};
+                        std::vector<tracker> copies(t + 1, a);
+                        tracker_mt           b{2};
+                        tracker_mt const     c{std::move(b)};
+                    }
+                    qs::lifecycle_counters const copied{1, t + 1, 0, 0, 0, t + 2};
+                    qs::lifecycle_counters const moved{1, 0, 1, 0, 0, 2};
+                    if(!(tracker::get_counters() == copied && tracker_mt::get_counters() == moved))
+                        ++mismatches;
+                }
+            });
+    for(std::thread& worker : workers)
+        worker.join();
+    EXPECT_EQ(mismatches.load(), 0u);
+
+    // nothing reached the static counters, which are used again outside of the scopes
+    EXPECT_EQ(tracker::get_counters(), qs::lifecycle_counters{});
+    EXPECT_EQ(tracker_mt::get_counters(), qs::lifecycle_counters{});
+    qs::lifecycle_counter_context outer;
+    {
+        qs::lifecycle_counter_scope const scope{outer};
+        tracker const                     a{1};
+        {
+            qs::lifecycle_counter_context     inner;
+            qs::lifecycle_counter_scope const inner_scope{inner};
+            tracker const                     b{a};
+            EXPECT_EQ(tracker::get_counters().copy_constructor, 1u);
+        }
+        EXPECT_EQ(qs::lifecycle_counter_context::current(), &outer);
+        EXPECT_EQ(tracker::get_counters().copy_constructor, 0u);
+        EXPECT_EQ(tracker::get_counters().alive(), 1u);
+    }
+    EXPECT_EQ(qs::lifecycle_counter_context::current(), nullptr);
+    EXPECT_EQ(tracker::get_counters(), qs::lifecycle_counters{});
+}
+
+
+
+TEST(LifecycleCounterContext, FreshBlocksAndObjectsOutlivingTheScope)
+{
+    using tracker = qs::lifecycle_tracker<Gadget, 24>;
+    tracker::set_sink(nullptr);
+    tracker::reset_counters();
+
+    // each context gets its own counters, even where a context reuses the address of the last
+    for(size_t round = 0; round < 3; ++round)
+    {
+        qs::lifecycle_counter_context     ctx;
+        qs::lifecycle_counter_scope const scope{ctx};
+        tracker const                     a{1};
+        tracker const                     b{a};
+        EXPECT_EQ(tracker::get_counters(), (qs::lifecycle_counters{1, 1, 0, 0, 0, 0}));
+    }
+
+    std::vector<tracker> kept;
+    {
+        qs::lifecycle_counter_context     ctx;
+        qs::lifecycle_counter_scope const scope{ctx};
+        kept.emplace_back(1);
+    }
+    kept.clear();
+    EXPECT_EQ(tracker::get_counters().alive(), -1);
+}
+
+
+struct SlowLogged
+{
+    int v;
+};
+
+template<size_t Uuid>
+struct qs::lifecycle_logger<SlowLogged, Uuid>
+{
+    template<qs::lifecycle_event Cnt>
+    void log_event(SlowLogged const&, std::string const&) const
+    {
+        auto const until = std::chrono::steady_clock::now() + std::chrono::microseconds{20};
+        while(std::chrono::steady_clock::now() < until)
+        {}
+    }
+
+    void print_counters(qs::lifecycle_counters const&, std::string const&) const {}
+};
+
+TEST(LifecycleOverhead, LoggerDominates)
+{
+    using tracker = qs::lifecycle_tracker<SlowLogged, 17>;
+    tracker::reset_counters();
+    tracker::set_overhead_timing_enabled(true);
+    {
+        tracker const a{};
+        tracker       b{a};
+        b = a;
+    }
+    qs::lifecycle_overhead const overhead = tracker::get_overhead();
+    EXPECT_EQ(overhead.events, 5u);
+    EXPECT_GE(overhead.logging_ns, 5u * 20000u);
+    EXPECT_GT(overhead.logging_ns, overhead.counting_ns);
+    EXPECT_EQ(overhead.total_ns(),
+              overhead.counting_ns + overhead.logging_ns + overhead.features_ns);
+
+    std::vector<qs::lifecycle_type_overhead> const all = qs::lifecycle_overheads::get_all();
+    auto const found = std::find_if(all.begin(), all.end(),
+                                    [](qs::lifecycle_type_overhead const& type)
+                                    { return type.uuid == 17 && type.type == "SlowLogged"; });
+    ASSERT_NE(found, all.end());
+    EXPECT_EQ(found->overhead.events, 5u);
+    EXPECT_GE(qs::lifecycle_overheads::get_total().events, 5u);
+
+    qs::lifecycle_ring_sink ring;
+    qs::lifecycle_overheads::print_all(&ring);
+    EXPECT_THAT(ring.contents(),
+                ::testing::HasSubstr("Lifecycle overhead [type: SlowLogged, uuid: 17]: 5 events"));
+    EXPECT_THAT(ring.contents(), ::testing::HasSubstr("Lifecycle overhead total: "));
+
+    tracker::set_overhead_timing_enabled(false);
+    tracker::reset_counters();
+    EXPECT_EQ(tracker::get_overhead().events, 0u);
+    // types without timed events are not listed
+    std::vector<qs::lifecycle_type_overhead> const after = qs::lifecycle_overheads::get_all();
+    EXPECT_TRUE(std::none_of(after.begin(), after.end(),
+                             [](qs::lifecycle_type_overhead const& type)
+                             { return type.uuid == 17 && type.type == "SlowLogged"; }));
+}
+
+
+TEST(LifecycleWatchdog, OneShotLimits)
+{
+    using tracker = qs::lifecycle_tracker_mt<Gadget, 18>;
+    tracker::set_sink(nullptr);
+    tracker::reset_counters();
+
+    std::vector<qs::lifecycle_watchdog_alert> alerts;
+    std::vector<std::string>                  names;
+    tracker::set_watchdog({100, 0, 50},
+                          [&alerts, &names](qs::lifecycle_watchdog_alert const& alert)
+                          {
+                              alerts.push_back(alert);
+                              names.push_back(alert.type_name);
+                          });
+    std::vector<tracker> kept;
+    kept.reserve(200);
+    for(int i = 0; i < 150; ++i)
+        kept.emplace_back(i);
+    ASSERT_EQ(alerts.size(), 1u); // once, at the 101st object
+    EXPECT_EQ(alerts[0].limit, qs::lifecycle_watchdog_limit::alive);
+    EXPECT_EQ(alerts[0].value, 101u);
+    EXPECT_EQ(alerts[0].threshold, 100u);
+    EXPECT_EQ(alerts[0].uuid, 18u);
+    EXPECT_EQ(names[0], tracker::get_type_name());
+
+    for(int i = 0; i < 40; ++i)
+        kept.push_back(kept[0]);
+    for(int i = 0; i < 40; ++i)
+        kept[1] = kept[0];
+    ASSERT_EQ(alerts.size(), 2u);
+    EXPECT_EQ(alerts[1].limit, qs::lifecycle_watchdog_limit::copies_per_sec);
+    EXPECT_EQ(alerts[1].value, 51u);
+
+    // without a callback, a warning goes to the sink of the type
+    qs::lifecycle_ring_sink ring;
+    tracker::set_sink(&ring);
+    tracker::set_watchdog({10, 0, 0});
+    kept.emplace_back(0);
+    qs::lifecycle_sinks::flush();
+    EXPECT_THAT(ring.contents(), ::testing::HasSubstr("Lifecycle watchdog [type: Gadget, uuid: 18]: "
+                                                      "191 alive objects, over the limit of 10\n"));
+    tracker::set_sink(nullptr);
+    tracker::set_watchdog({0, 0, 0});
+    kept.clear();
+}
+
+
+TEST(LifecycleRegistry, DenseSnapshotAndTotal)
+{
+    using tracker    = qs::lifecycle_tracker<Gadget, 19>;
+    using tracker_mt = qs::lifecycle_tracker_mt<Gadget, 19>;
+    tracker::set_sink(nullptr);
+    tracker_mt::set_sink(nullptr);
+    tracker::reset_counters();
+    tracker_mt::reset_counters();
+    {
+        tracker    a{1};
+        tracker    b{a};
+        tracker_mt c{2};
+        tracker_mt d{std::move(c)};
+        d = c;
+    }
+
+    std::vector<qs::lifecycle_counters> snapshot;
+    qs::lifecycle_registry::snapshot(snapshot);
+    ASSERT_EQ(snapshot.size(), qs::lifecycle_registry::size());
+
+    qs::lifecycle_counters sum{};
+    size_t                 found = 0;
+    for(size_t id = 0; id < snapshot.size(); ++id)
+    {
+        qs::lifecycle_type_entry const* const entry = qs::lifecycle_registry::get(id);
+        if(entry == nullptr)
+            continue;
+        EXPECT_EQ(snapshot[id], entry->counters()) << entry->type_name();
+        if(entry->uuid == 19 && entry->type_name() == tracker::get_type_name())
+        {
+            EXPECT_EQ(snapshot[id],
+                      entry->mt ? tracker_mt::get_counters() : tracker::get_counters());
+            ++found;
+        }
+        sum = qs::lifecycle_registry::sum({sum, snapshot[id]});
+    }
+    EXPECT_EQ(found, 2u);
+    EXPECT_EQ(tracker::get_counters(), (qs::lifecycle_counters{1, 1, 0, 0, 0, 2}));
+    EXPECT_EQ(tracker_mt::get_counters(), (qs::lifecycle_counters{1, 0, 1, 1, 0, 2}));
+    EXPECT_EQ(qs::lifecycle_registry::total(), sum);
+}
+
+
+TEST(LifecycleTrace, AnalyzeReproducesCounters)
+{
+    using tracker    = qs::lifecycle_tracker<Gadget, 20>;
+    using tracker_mt = qs::lifecycle_tracker_mt<Gadget, 20>;
+    tracker::set_sink(nullptr);
+    tracker_mt::set_sink(nullptr);
+    tracker::reset_counters();
+    tracker_mt::reset_counters();
+
+    tracker                    before{0}; // in the counters read when the trace opens
+    std::string const          path = ::testing::TempDir() + "lifecycle_trace.qstrace";
+    qs::lifecycle_trace_writer trace{path.c_str()};
+    ASSERT_TRUE(trace.is_open());
+    {
+        std::vector<tracker> kept;
+        kept.reserve(100);
+        for(int i = 0; i < 100; ++i)
+            kept.emplace_back(i);
+        std::vector<tracker> const copies{kept};
+
+        std::vector<std::thread> threads;
+        for(int t = 0; t < 4; ++t)
+            threads.emplace_back(
+                []
+                {
+                    for(int i = 0; i < 250; ++i)
+                    {
+                        tracker_mt a{i};
+                        tracker_mt b{a};
+                    }
+                });
+        for(std::thread& thread : threads)
+            thread.join();
+        tracker moved{std::move(before)};
+    }
+    ASSERT_TRUE(trace.close());
+
+    qs::lifecycle_trace_options options;
+    options.threads       = 4;
+    options.chunk_records = 64; // objects live across chunks
+    qs::lifecycle_trace_analysis analysis;
+    ASSERT_TRUE(qs::lifecycle_trace::analyze(path.c_str(), analysis, options));
+    EXPECT_EQ(analysis.records, 100u + 100u + 200u + 2000u + 2000u + 2u);
+    ASSERT_EQ(analysis.types.size(), 2u);
+
+    for(qs::lifecycle_trace_type const& type : analysis.types)
+    {
+        EXPECT_EQ(type.uuid, 20u);
+        EXPECT_EQ(type.counters(), type.mt ? tracker_mt::get_counters() : tracker::get_counters());
+        EXPECT_EQ(type.counters(), type.closing);
+        size_t lived = 0;
+        for(size_t const count : type.lifetimes)
+            lived += count;
+        EXPECT_EQ(lived, type.mt ? 2000u : 201u); // all but the one constructed before the trace
+#if QS_LIFECYCLE_TRACKER_WITH_BACKTRACE
+        size_t copies = 0;
+        for(qs::lifecycle_trace_site const& site : type.copy_sites)
+            copies += site.count;
+        EXPECT_EQ(copies, type.mt ? 1000u : 100u);
+#endif
+    }
+    ASSERT_FALSE(analysis.alive.empty());
+    EXPECT_EQ(analysis.alive.back(), 1); // `before`, moved from but alive
+
+    qs::lifecycle_ring_sink ring;
+    tracker::set_sink(&ring);
+    tracker::print_counters();
+    qs::lifecycle_sinks::flush();
+    tracker::set_sink(nullptr);
+    EXPECT_THAT(qs::lifecycle_trace::format(analysis), ::testing::HasSubstr(ring.contents()));
+    std::remove(path.c_str());
+}
+
+
+TEST(LifecycleBudget, MeasuresOnlyTheBlockOnTheCallingThread)
+{
+    using tracker = qs::lifecycle_tracker<Gadget, 21>;
+    tracker::set_sink(nullptr);
+    tracker::reset_counters();
+
+    tracker              a{1};
+    std::vector<tracker> kept;
+    kept.reserve(4);
+    qs::lifecycle_budget budget;
+    budget.copies = 1;
+    budget.moves  = 1;
+    EXPECT_LIFECYCLE_BUDGET(tracker, budget)
+    {
+        kept.push_back(a);
+        kept.push_back(std::move(a));
+        std::thread{[&a] { tracker const other{a}; }}.join(); // not on this thread
+    }
+    // the events of the block are still in the static counters
+    EXPECT_EQ(tracker::get_counters(), (qs::lifecycle_counters{1, 2, 1, 0, 0, 1}));
+
+    budget.copies = 0;
+    EXPECT_NONFATAL_FAILURE(EXPECT_LIFECYCLE_BUDGET(tracker, budget) { kept[0] = kept[1]; },
+                            "Lifecycle budget [type: Gadget, uuid: 21] exceeded\n"
+                            " * copies        : 1 (budget 0), over by 1\n"
+                            " * moves         : 0 (budget 1)\n"
+                            "Lifecycle tracker [type: Gadget, uuid: 21]\n");
+    EXPECT_EQ(tracker::get_counters().copy_assignment, 1u);
+
+    // inside a counter context, the block is added back to that context
+    qs::lifecycle_counter_context ctx;
+    {
+        qs::lifecycle_counter_scope const scope{ctx};
+        ASSERT_LIFECYCLE_BUDGET(tracker, budget)
+        {
+            tracker b{std::move(kept[0])};
+        }
+        EXPECT_EQ(tracker::get_counters(), (qs::lifecycle_counters{0, 0, 1, 0, 0, 1}));
+    }
+    EXPECT_EQ(tracker::get_counters().move_constructor, 1u);
+}
+
+
+struct Blob
+{
+    Blob(size_t size)
+        : size{size} {};
+    size_t size{};
+};
+
+struct Message
+{
+    Message(std::string text)
+        : text{std::move(text)} {};
+    std::string text;
+};
+
+template<size_t Uuid>
+struct qs::lifecycle_log_filter<Blob, Uuid>
+{
+    bool operator()(Blob const& blob) const { return blob.size > 4096; }
+};
+
+TEST(LifecycleLogFilter, LogsAndCountsHeavyEvents)
+{
+    using messages = qs::lifecycle_tracker<Message, 22>;
+    qs::lifecycle_ring_sink ring;
+    messages::set_sink(&ring);
+    messages::set_log_filter([](Message const& message) { return message.text.size() > 8; });
+    {
+        messages const small{"abc"};
+        messages const big{"0123456789"};
+        messages const small_copy{small};
+        messages const big_copy{big};
+    }
+    qs::lifecycle_sinks::flush();
+    EXPECT_EQ(ring.contents(), "Message(...)\nMessage(Message const&)\n~Message()\n~Message()\n");
+    EXPECT_EQ(messages::get_heavy_counters(), (qs::lifecycle_counters{1, 1, 0, 0, 0, 2}));
+    EXPECT_EQ(messages::get_counters(), (qs::lifecycle_counters{2, 2, 0, 0, 0, 4}));
+    messages::set_log_filter({});
+    messages::reset_counters();
+    EXPECT_EQ(messages::get_heavy_counters(), qs::lifecycle_counters{});
+    messages::reset_sink();
+
+    // a specialized qs::lifecycle_log_filter, reported after the counters
+    using blobs = qs::lifecycle_tracker<Blob, 22>;
+    qs::lifecycle_ring_sink blob_ring;
+    blobs::set_sink(&blob_ring);
+    {
+        blobs const small{16};
+        blobs const big{1 << 20};
+        blobs const big_copy{big};
+    }
+    blobs::print_counters();
+    EXPECT_EQ(blobs::get_heavy_counters(), (qs::lifecycle_counters{1, 1, 0, 0, 0, 2}));
+    EXPECT_THAT(blob_ring.contents(),
+                ::testing::HasSubstr("Lifecycle heavy events [type: Blob, uuid: 22]\n"
+                                     " * constructor (ctor/copy/move) :     2 (1/1/0)\n"));
+
+    // the filter is not called while logging is disabled
+    size_t calls = 0;
+    blobs::set_log_filter([&calls](Blob const&) { return ++calls != 0; });
+    blobs::set_sink(nullptr);
+    {
+        blobs const big{1 << 20};
+    }
+    EXPECT_EQ(calls, 0u);
+    blobs::set_log_filter({});
+    blobs::reset_sink();
+}
+
+
+
+TEST(LifecycleLogFilter, ReplacesFiltersWhileLogging)
+{
+    using messages = qs::lifecycle_tracker_mt<Message, 24>;
+    qs::lifecycle_ring_sink ring;
+    messages::set_sink(&ring);
+    messages::set_log_filter([](Message const&) { return false; });
+
+    std::atomic<bool> stop{false};
+    std::thread       events{[&stop]
+                       {
+                           while(!stop.load())
+                               messages const m{"m"};
+                       }};
+
+    auto                     owner = std::make_shared<int>(0);
+    std::weak_ptr<int> const held  = owner;
+    messages::set_log_filter([owner](Message const&) { return false; });
+    owner.reset();
+    for(int i = 0; i < 100; ++i)
+        messages::set_log_filter([](Message const&) { return false; });
+    stop = true;
+    events.join();
+    // the replaced filter is retired, and freed by the first change without a reader
+    messages::set_log_filter([](Message const&) { return false; });
+    EXPECT_TRUE(held.expired());
+    EXPECT_EQ(messages::get_heavy_counters(), qs::lifecycle_counters{});
+    messages::set_log_filter({});
+    messages::reset_sink();
+}
+
+
+TEST(LifecycleMoveQuality, CountsEventsOfMovedFromObjects)
+{
+    using messages = qs::lifecycle_tracker<Message, 23>;
+    messages::set_sink(nullptr);
+    messages::set_move_quality_enabled(true);
+    {
+        messages a{"a"};
+        messages b{std::move(a)};
+        messages c{std::move(a)}; // a was already moved from
+        a = b;                    // copy assignment into a moved-from object
+        messages d{"d"};
+        d = std::move(c);
+    }
+    qs::lifecycle_move_quality const quality = messages::get_move_quality();
+    EXPECT_EQ(quality.moves_from_moved, 1u);
+    EXPECT_EQ(quality.copy_assignments_into_moved, 1u);
+    EXPECT_EQ(quality.moved_destructions, 1u);
+    EXPECT_EQ(quality.live_destructions, 3u);
+
+    qs::lifecycle_ring_sink ring;
+    messages::print_move_quality(&ring);
+    EXPECT_EQ(ring.contents(), "Lifecycle move quality [type: Message, uuid: 23]\n"
+                               " * moves from a moved-from object            : 1\n"
+                               " * copy assignments into a moved-from object : 1\n"
+                               " * destructions (moved-from/live)            : 4 (1/3)\n");
+
+    messages::set_move_quality_enabled(false);
+    EXPECT_EQ(messages::get_move_quality().live_destructions, 0u);
+    messages::reset_sink();
+}
+
+
+struct StaticLiteral
+{
+    constexpr StaticLiteral(int value)
+        : value{value} {};
+    int value{};
+};
+
+// constructed during static initialization, possibly before the statics of its tracker
+static qs::lifecycle_tracker<StaticLiteral, 24> static_literal{1};
+
+TEST(LifetimeTracker, NamespaceScopeTracker)
+{
+    using tracker = qs::lifecycle_tracker<StaticLiteral, 24>;
+    EXPECT_EQ(static_literal.value, 1);
+    EXPECT_EQ(tracker::get_type_name(), "StaticLiteral");
+    EXPECT_EQ(tracker::get_counters().constructor, 1u);
+    EXPECT_EQ(tracker::get_counters().alive(), 1);
+}
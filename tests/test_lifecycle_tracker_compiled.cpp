@@ -0,0 +1,87 @@
+#include <gmock/gmock.h>
+
+#include <qs/lifecycle_tracker_fwd.h>
+
+// naming tracked types only needs the forward declarations
+struct Widget;
+using tracked_widget = qs::lifecycle_tracker<Widget, 1>;
+
+#include <qs/lifecycle_tracker.h>
+
+#include <cstdlib>
+
+#if defined(FMT_VERSION) || defined(__cpp_lib_format)
+#error "the compiled tracker must not include a formatting library"
+#endif
+
+
+struct Widget
+{
+    Widget(int id)
+        : id{id}
+    {}
+
+    int id{};
+};
+
+
+struct Gadget
+{};
+
+
+// First, since the environment is only read before the first sink is used or set
+TEST(LifecycleCompiled, EnvironmentKeepsSinksSetInCode)
+{
+    ::setenv(QS_LIFECYCLE_SINK_ENV, "null;Widget=stderr", 1);
+
+    using tracker = qs::lifecycle_tracker<Widget, 2>;
+    qs::lifecycle_ring_sink ring;
+    tracker::set_sink(&ring);
+    {
+        tracker const w{2};
+        // written as it is logged, without a flush
+        EXPECT_EQ(ring.contents(), "Widget(...)\n");
+    }
+    EXPECT_EQ(ring.contents(), "Widget(...)\n~Widget()\n");
+    EXPECT_EQ(tracker::get_sink(), &ring);
+    EXPECT_EQ(qs::lifecycle_sinks::get_default(), nullptr);
+
+    // a type that the environment turns off skips logging, so its filter is never called
+    using gadget = qs::lifecycle_tracker<Gadget, 2>;
+    size_t calls = 0;
+    gadget::set_log_filter([&calls](Gadget const&) { return ++calls != 0; });
+    {
+        gadget const g{};
+    }
+    EXPECT_EQ(gadget::get_sink(), nullptr);
+    EXPECT_EQ(calls, 0u);
+    gadget::set_log_filter({});
+
+    // an explicit configuration replaces the sinks set in code
+    ASSERT_TRUE(qs::lifecycle_sinks::configure("null"));
+    EXPECT_EQ(tracker::get_sink(), nullptr);
+    ::unsetenv(QS_LIFECYCLE_SINK_ENV);
+    qs::lifecycle_sinks::set_default(qs::lifecycle_sinks::stdout_sink());
+}
+
+
+TEST(LifecycleCompiled, FormatsOutOfLine)
+{
+    qs::lifecycle_ring_sink ring;
+    tracked_widget::set_sink(&ring);
+    {
+        tracked_widget a{1};
+        tracked_widget b{a};
+    }
+    tracked_widget::print_counters();
+
+    EXPECT_EQ(ring.contents(), "Widget(...)\n"
+                               "Widget(Widget const&)\n"
+                               "~Widget()\n"
+                               "~Widget()\n"
+                               "Lifecycle tracker [type: Widget, uuid: 1]\n"
+                               " * constructor (ctor/copy/move) :     2 (1/1/0)\n"
+                               " * assign (copy/move)           :     0 (0/0)\n"
+                               " * destructor (alive)           :     2 (0)\n");
+    tracked_widget::reset_sink();
+}
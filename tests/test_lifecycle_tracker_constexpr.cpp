@@ -0,0 +1,73 @@
+#include <gmock/gmock.h>
+
+#include <qs/lifecycle_tracker.h>
+
+#include <array>
+#include <utility>
+#include <vector>
+
+
+struct Point
+{
+    constexpr Point(int x, int y)
+        : x{x}, y{y}
+    {}
+
+    int x{};
+    int y{};
+};
+
+using tracked    = qs::lifecycle_tracker<Point>;
+using tracked_mt = qs::lifecycle_tracker_mt<Point>;
+
+
+template<class Fn>
+constexpr qs::lifecycle_counters count_events(Fn fn)
+{
+    qs::lifecycle_constexpr_context ctx;
+    fn(ctx);
+    return ctx.counters();
+}
+
+
+static_assert(count_events([](qs::lifecycle_constexpr_context& ctx) {
+                  tracked a{ctx, 1, 2};
+                  tracked b{ctx, 3, 4};
+                  std::swap(a, b);
+              }) == qs::lifecycle_counters{2, 0, 1, 0, 2, 3});
+
+static_assert(count_events([](qs::lifecycle_constexpr_context& ctx) {
+                  std::array<tracked_mt, 2> points{{{ctx, 1, 2}, {ctx, 3, 4}}};
+                  tracked_mt                copy = points[0];
+                  copy                           = points[1];
+              }) == qs::lifecycle_counters{2, 1, 0, 1, 0, 3});
+
+// zero-copy proof of building a vector
+static_assert(count_events([](qs::lifecycle_constexpr_context& ctx) {
+                  std::vector<tracked> points;
+                  points.reserve(2);
+                  points.emplace_back(ctx, 1, 2);
+                  points.push_back(tracked{ctx, 3, 4});
+              }).copy_constructor == 0);
+
+static_assert(count_events([](qs::lifecycle_constexpr_context& ctx) {
+                  qs::lifecycle_tracker<void, 1> a{ctx};
+                  qs::lifecycle_tracker<void, 1> b;
+                  b = a;
+              }) == qs::lifecycle_counters{1, 0, 0, 1, 0, 2});
+
+
+TEST(LifecycleConstexpr, RuntimeUsesStaticCounters)
+{
+    using tracker = qs::lifecycle_tracker<Point, 1>;
+    tracker::set_sink(nullptr);
+
+    qs::lifecycle_constexpr_context ctx;
+    {
+        tracker a{ctx, 1, 2};
+        tracker b{a};
+        EXPECT_EQ(b.x, 1);
+    }
+    EXPECT_EQ(tracker::get_counters(), (qs::lifecycle_counters{1, 1, 0, 0, 0, 2}));
+    EXPECT_EQ(ctx.counters(), (qs::lifecycle_counters{}));
+}
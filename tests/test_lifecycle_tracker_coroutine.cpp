@@ -0,0 +1,125 @@
+#include <gmock/gmock.h>
+
+#include <qs/lifecycle_tracker.h>
+
+#include <coroutine>
+#include <exception>
+#include <thread>
+#include <vector>
+
+
+struct Job
+{
+    Job(int id)
+        : id{id}
+    {}
+
+    int id{};
+};
+
+using tracker = qs::lifecycle_tracker_mt<Job>;
+
+
+// Coroutine that starts eagerly and frees its frame when it completes
+struct detached
+{
+    struct promise_type
+    {
+        detached           get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void               return_void() noexcept {}
+        [[noreturn]] void  unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+// Awaiter that resumes the coroutine on a new thread, inside a task of that thread
+struct resume_on_pool
+{
+    std::thread&                pool;
+    qs::lifecycle_task_context& after_resume;
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        // the frame, and this awaiter with it, may be gone once the thread starts
+        std::thread&                started = pool;
+        qs::lifecycle_task_context& after   = after_resume;
+        started = std::thread{[handle, &after]
+                              {
+                                  qs::lifecycle_task_scope const scope{
+                                      qs::lifecycle_task_context::start("POOL")};
+                                  handle.resume();
+                                  after = qs::lifecycle_task_context::current();
+                                  tracker const own{3};
+                              }};
+    }
+
+    void await_resume() const noexcept {}
+};
+
+detached run_job(qs::lifecycle_task_context& inside)
+{
+    qs::lifecycle_task_scope scope{qs::lifecycle_task_context::start("JOB")};
+    co_await qs::lifecycle_carry_task(scope, std::suspend_never{});
+    inside = qs::lifecycle_task_context::current();
+}
+
+detached handle_get(std::thread& pool, qs::lifecycle_task_context& after_resume,
+                    qs::lifecycle_task_context& resumed_in)
+{
+    qs::lifecycle_task_scope scope{qs::lifecycle_task_context::start("GET")};
+    tracker const            a{1};
+    co_await qs::lifecycle_carry_task(scope, resume_on_pool{pool, after_resume});
+    resumed_in = qs::lifecycle_task_context::current();
+    tracker const b{a};
+}
+
+
+TEST(LifecycleCoroutine, TaskFollowsTheCoroutineAcrossThreads)
+{
+    tracker::set_sink(nullptr);
+    tracker::set_task_counters_enabled(true);
+
+    qs::lifecycle_task_context const main = qs::lifecycle_task_context::start("MAIN");
+    qs::lifecycle_task_context       after_resume;
+    qs::lifecycle_task_context       resumed_in;
+    std::thread                      pool;
+    {
+        qs::lifecycle_task_scope const scope{main};
+        handle_get(pool, after_resume, resumed_in);
+        // suspended: this thread is back in its own task
+        EXPECT_EQ(qs::lifecycle_task_context::current(), main);
+        tracker const own{2};
+    }
+    pool.join();
+    EXPECT_FALSE(qs::lifecycle_task_context::current());
+    EXPECT_EQ(resumed_in.name(), "GET");
+    EXPECT_EQ(after_resume.name(), "POOL");
+
+    std::vector<qs::lifecycle_task_counters> const tasks = tracker::get_task_counters();
+    ASSERT_EQ(tasks.size(), 3u);
+    EXPECT_EQ(tasks[0].task, "MAIN");
+    EXPECT_EQ(tasks[0].counters, (qs::lifecycle_counters{1, 0, 0, 0, 0, 1}));
+    EXPECT_EQ(tasks[1].task, "GET");
+    EXPECT_EQ(tasks[1].counters, (qs::lifecycle_counters{1, 1, 0, 0, 0, 2}));
+    EXPECT_EQ(tasks[2].task, "POOL");
+    EXPECT_EQ(tasks[2].counters, (qs::lifecycle_counters{1, 0, 0, 0, 0, 1}));
+    tracker::set_task_counters_enabled(false);
+}
+
+
+TEST(LifecycleCoroutine, ReadyAwaiterKeepsTheScope)
+{
+    qs::lifecycle_task_context const main = qs::lifecycle_task_context::start("MAIN");
+    qs::lifecycle_task_context       inside;
+    {
+        qs::lifecycle_task_scope const scope{main};
+        run_job(inside);
+        // the coroutine never suspended, and its scope restored the task of this thread
+        EXPECT_EQ(qs::lifecycle_task_context::current(), main);
+    }
+    EXPECT_EQ(inside.name(), "JOB");
+    EXPECT_FALSE(qs::lifecycle_task_context::current());
+}
@@ -0,0 +1,70 @@
+#include <gmock/gmock.h>
+
+#include <string>
+
+import qs.lifecycle_tracker;
+
+
+struct Widget
+{
+    Widget(int id)
+        : id{id}
+    {}
+
+    int id{};
+};
+
+
+TEST(LifecycleModule, TrackersThroughImport)
+{
+    using tracker    = qs::lifecycle_tracker<Widget, 1>;
+    using tracker_mt = qs::lifecycle_tracker_mt<Widget, 3>;
+
+    qs::lifecycle_ring_sink ring;
+    tracker::set_sink(&ring);
+    tracker_mt::set_sink(nullptr);
+    {
+        tracker    a{1};
+        tracker    b{a};
+        tracker_mt c{2};
+        tracker_mt d{std::move(c)};
+    }
+    tracker::print_counters();
+    qs::lifecycle_sinks::flush();
+
+    EXPECT_EQ(ring.contents(), "Widget(...)\n"
+                               "Widget(Widget const&)\n"
+                               "~Widget()\n"
+                               "~Widget()\n"
+                               "Lifecycle tracker [type: Widget, uuid: 1]\n"
+                               " * constructor (ctor/copy/move) :     2 (1/1/0)\n"
+                               " * assign (copy/move)           :     0 (0/0)\n"
+                               " * destructor (alive)           :     2 (0)\n");
+    EXPECT_EQ(tracker_mt::get_counters().move_constructor, 1u);
+    tracker::reset_sink();
+}
+
+
+TEST(LifecycleModule, SubscribersContextsAndRegistry)
+{
+    using tracked_int = qs::tracked<int, 2>;
+    tracked_int::set_sink(nullptr);
+
+    size_t                     copies       = 0;
+    qs::lifecycle_subscription subscription = qs::lifecycle_subscribers::subscribe(
+        [&copies](qs::lifecycle_event_info const& info)
+        { copies += info.event == qs::lifecycle_event::CopyConstructor; });
+    qs::lifecycle_counter_context ctx;
+    {
+        qs::lifecycle_counter_scope const scope{ctx};
+        tracked_int const                 a{1};
+        tracked_int const                 b{a};
+        EXPECT_EQ(*b, 1);
+        EXPECT_EQ(tracked_int::get_counters().copy_constructor, 1u);
+    }
+    subscription.unsubscribe();
+
+    EXPECT_EQ(copies, 1u);
+    EXPECT_EQ(tracked_int::get_counters().copy_constructor, 0u); // counted in the context
+    EXPECT_THAT(qs::lifecycle_registry::to_json(), ::testing::HasSubstr("\"uuid\": 2"));
+}
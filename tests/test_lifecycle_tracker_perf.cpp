@@ -0,0 +1,119 @@
+#include <gmock/gmock.h>
+
+#include <qs/lifecycle_tracker.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+
+struct Blob
+{
+    Blob(size_t size)
+        : bytes(size, 'x')
+    {}
+
+    std::vector<char> bytes;
+};
+
+struct Holder
+{
+    Holder(size_t size)
+        : blob{size}
+    {}
+
+    qs::lifecycle_tracker<Blob, 2> blob;
+};
+
+
+TEST(LifecyclePerf, CountsCopiesAndMoves)
+{
+    using tracker = qs::lifecycle_tracker<Blob, 1>;
+    tracker::set_sink(nullptr);
+    tracker::set_perf_counters_enabled(true);
+    {
+        tracker       a{1 << 16};
+        tracker       b{a};
+        tracker const c{std::move(b)};
+        b = c;
+        a = std::move(b);
+    }
+
+    std::vector<qs::lifecycle_perf_counters> const perf = tracker::get_perf_counters();
+    ASSERT_EQ(perf.size(), 4u);
+    for(qs::lifecycle_perf_counters const& p : perf)
+    {
+        EXPECT_EQ(p.operations, 1u);
+        EXPECT_LE(p.measured, p.operations);
+        if(p.measured != 0 && p.event == qs::lifecycle_event::CopyConstructor)
+        {
+            EXPECT_GT(p.instructions, 0u);
+        }
+    }
+
+    qs::lifecycle_ring_sink ring;
+    tracker::set_sink(&ring);
+    tracker::print_counters();
+    EXPECT_THAT(ring.contents(), ::testing::HasSubstr("Lifecycle perf counters [type: Blob, uuid: 1]\n"
+                                                      " * copy_constructor: 1 ops"));
+
+    tracker::reset_counters();
+    EXPECT_EQ(tracker::get_perf_counters()[0].operations, 0u);
+    tracker::set_perf_counters_enabled(false);
+    tracker::reset_sink();
+}
+
+
+TEST(LifecyclePerf, NestedTrackedMembers)
+{
+    using outer = qs::lifecycle_tracker<Holder, 2>;
+    using inner = qs::lifecycle_tracker<Blob, 2>;
+    outer::set_sink(nullptr);
+    inner::set_sink(nullptr);
+    outer::set_perf_counters_enabled(true);
+    inner::set_perf_counters_enabled(true);
+    {
+        outer const a{64};
+        outer const b{a};
+        static_cast<void>(b);
+    }
+
+    std::vector<qs::lifecycle_perf_counters> const outer_perf = outer::get_perf_counters();
+    std::vector<qs::lifecycle_perf_counters> const inner_perf = inner::get_perf_counters();
+    EXPECT_EQ(outer_perf[0].operations, 1u);
+    EXPECT_EQ(inner_perf[0].operations, 1u);
+    if(outer_perf[0].measured != 0 && inner_perf[0].measured != 0)
+    {
+        EXPECT_GE(outer_perf[0].instructions, inner_perf[0].instructions);
+    }
+
+    outer::set_perf_counters_enabled(false);
+    inner::set_perf_counters_enabled(false);
+}
+
+
+TEST(LifecyclePerf, DisabledEventsDoNotLeaveReadings)
+{
+    using tracker = qs::lifecycle_tracker<Blob, 3>;
+    tracker::set_sink(nullptr);
+    tracker::set_perf_counters_enabled(true);
+    tracker::set_event_enabled(qs::lifecycle_event::CopyConstructor, false);
+    {
+        tracker const        a{64};
+        std::vector<tracker> copies;
+        copies.reserve(2 * QS_LIFECYCLE_PERF_DEPTH);
+        for(int i = 0; i < 2 * QS_LIFECYCLE_PERF_DEPTH; ++i)
+            copies.push_back(a);
+        tracker::set_event_enabled(qs::lifecycle_event::CopyConstructor, true);
+        tracker const c{a};
+        static_cast<void>(c);
+    }
+
+    std::vector<qs::lifecycle_perf_counters> const perf = tracker::get_perf_counters();
+    EXPECT_EQ(perf[0].event, qs::lifecycle_event::CopyConstructor);
+    EXPECT_EQ(perf[0].operations, 1u);
+    EXPECT_EQ(tracker::get_counters().copy_constructor, 1u);
+
+    tracker::set_perf_counters_enabled(false);
+    tracker::reset_sink();
+}
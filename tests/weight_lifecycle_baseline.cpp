@@ -0,0 +1,19 @@
+// What the header-only tracker included before the compiled library existed, preprocessed by
+// the LifecycleHeaderWeight test as the upper bound for a compiled translation unit.
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <exception>
+#include <memory>
+#include <new>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+#include <cxxabi.h>
+#include <fmt/core.h>
+#include <fmt/format.h>
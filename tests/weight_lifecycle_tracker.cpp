@@ -0,0 +1,14 @@
+// Translation unit of a type instrumented with the compiled tracker, preprocessed by the
+// LifecycleHeaderWeight test.
+
+#include <qs/lifecycle_tracker.h>
+
+struct Tracked
+{
+    qs::lifecycle_tracker<Tracked> tracker;
+};
+
+Tracked lifecycle_weight_copy(Tracked const& in)
+{
+    return in;
+}
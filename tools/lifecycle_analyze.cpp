@@ -0,0 +1,71 @@
+// Analyzes a trace written with qs::lifecycle_trace_writer on every core and prints the counters
+// as print_counters() reported them, the lifetimes, the top copy sites and the alive objects
+// over time.
+//
+//   lifecycle_analyze <trace> [--threads count] [--chunk records] [--points count] [--top count]
+//
+// Exits with 0, 1 when the counters of a type differ from the ones read when the trace was
+// closed, and 2 on invalid input.
+
+#include <qs/lifecycle_trace.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+
+namespace
+{
+    int usage(char const* prog)
+    {
+        std::fprintf(stderr,
+                     "usage: %s <trace> [--threads count] [--chunk records] [--points count] "
+                     "[--top count]\n",
+                     prog);
+        return 2;
+    }
+} // namespace
+
+
+int main(int argc, char** argv)
+{
+    if(argc < 2)
+        return usage(argv[0]);
+
+    qs::lifecycle_trace_options options{};
+    for(int i = 2; i < argc; ++i)
+    {
+        if(i + 1 >= argc)
+            return usage(argv[0]);
+        char const* const        value = argv[++i];
+        char*                    end   = nullptr;
+        unsigned long long const count = std::strtoull(value, &end, 10);
+        if(end == value || *end != '\0')
+            return usage(argv[0]);
+        if(std::strcmp(argv[i - 1], "--threads") == 0)
+            options.threads = static_cast<unsigned>(count);
+        else if(std::strcmp(argv[i - 1], "--chunk") == 0)
+            options.chunk_records = static_cast<size_t>(count);
+        else if(std::strcmp(argv[i - 1], "--points") == 0)
+            options.timeline_points = static_cast<size_t>(count);
+        else if(std::strcmp(argv[i - 1], "--top") == 0)
+            options.top_sites = static_cast<size_t>(count);
+        else
+            return usage(argv[0]);
+    }
+
+    qs::lifecycle_trace_analysis analysis;
+    if(!qs::lifecycle_trace::analyze(argv[1], analysis, options))
+    {
+        std::fprintf(stderr, "%s: cannot read trace '%s'\n", argv[0], argv[1]);
+        return 2;
+    }
+
+    std::string const report = qs::lifecycle_trace::format(analysis);
+    std::fwrite(report.data(), 1, report.size(), stdout);
+    for(qs::lifecycle_trace_type const& type : analysis.types)
+        if(!(type.counters() == type.closing))
+            return 1;
+    return 0;
+}
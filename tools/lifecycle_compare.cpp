@@ -0,0 +1,108 @@
+// Compares two counter dumps written with QS_LIFECYCLE_DUMP and reports the counters that grew.
+//
+//   lifecycle_compare <baseline.json> <current.json> [--threshold ratio] [--min-delta count]
+//                     [--events constructor,copy_constructor,...] [--ignore-new-types]
+//
+// Types missing from the baseline are compared with zero counters unless --ignore-new-types.
+// Exits with 0 when there are no regressions, 1 when there are, and 2 on invalid input.
+
+#include <qs/lifecycle_baseline.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+    int usage(char const* prog)
+    {
+        std::fprintf(stderr,
+                     "usage: %s <baseline.json> <current.json> [--threshold ratio] "
+                     "[--min-delta count] [--events name,...] [--ignore-new-types]\n",
+                     prog);
+        return 2;
+    }
+
+    bool parse_events(char const* list, qs::lifecycle_event_mask& mask)
+    {
+        mask = 0;
+        std::string const spec{list};
+        for(size_t pos = 0; pos <= spec.size();)
+        {
+            size_t const end  = std::min(spec.find(',', pos), spec.size());
+            std::string  name = spec.substr(pos, end - pos);
+            bool         found = false;
+            for(size_t i = 0; i < 6; ++i)
+            {
+                auto const event = static_cast<qs::lifecycle_event>(i);
+                if(name == qs::lifecycle_baseline::counter_name(event))
+                {
+                    mask |= qs::lifecycle_event_bit(event);
+                    found = true;
+                }
+            }
+            if(!found)
+                return false;
+            pos = end + 1;
+        }
+        return true;
+    }
+} // namespace
+
+
+int main(int argc, char** argv)
+{
+    if(argc < 3)
+        return usage(argv[0]);
+
+    qs::lifecycle_compare_options options{};
+    for(int i = 3; i < argc; ++i)
+    {
+        if(std::strcmp(argv[i], "--ignore-new-types") == 0)
+        {
+            options.ignore_new_types = true;
+            continue;
+        }
+        if(i + 1 >= argc)
+            return usage(argv[0]);
+        char const* const value = argv[++i];
+        char*             end   = nullptr;
+        if(std::strcmp(argv[i - 1], "--threshold") == 0)
+            options.max_ratio = std::strtod(value, &end);
+        else if(std::strcmp(argv[i - 1], "--min-delta") == 0)
+            options.min_delta = std::strtoull(value, &end, 10);
+        else if(std::strcmp(argv[i - 1], "--events") == 0)
+        {
+            if(!parse_events(value, options.events))
+                return usage(argv[0]);
+            continue;
+        }
+        else
+            return usage(argv[0]);
+        if(end == value || *end != '\0')
+            return usage(argv[0]);
+    }
+
+    std::vector<qs::lifecycle_baseline_entry> baseline, current;
+    if(!qs::lifecycle_baseline::load(argv[1], baseline))
+    {
+        std::fprintf(stderr, "%s: cannot read counter dump '%s'\n", argv[0], argv[1]);
+        return 2;
+    }
+    if(!qs::lifecycle_baseline::load(argv[2], current))
+    {
+        std::fprintf(stderr, "%s: cannot read counter dump '%s'\n", argv[0], argv[2]);
+        return 2;
+    }
+
+    auto const regressions = qs::lifecycle_baseline::compare(baseline, current, options);
+    for(qs::lifecycle_regression const& r : regressions)
+        std::printf("%s: %s %zu -> %zu%s\n", r.key.c_str(),
+                    qs::lifecycle_baseline::counter_name(r.event), r.baseline, r.current,
+                    r.new_type ? " (new type)" : "");
+
+    return regressions.empty() ? 0 : 1;
+}
@@ -0,0 +1,147 @@
+// Measures how counting lifecycle events scales with the number of threads, for the counters
+// of qs::lifecycle_tracker_mt and for alternative designs, and prints one CSV row per design
+// and thread count.
+//
+//   lifecycle_scaling [max_threads] [events_per_thread]
+//
+// Designs:
+//   tracker_mt      qs::lifecycle_tracker_mt, one cache-line padded atomic per event
+//   tracker_mt_tls  the same, with the per-thread counters feature also enabled
+//   shared_atomic   the six atomics packed in one cache line, as before the padding
+//   thread_local    plain per-thread counters summed after joining, the contention-free bound
+
+#include <qs/lifecycle_tracker.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+    struct payload
+    {
+        payload(size_t v)
+            : value{v}
+        {}
+        size_t value;
+    };
+
+    using tracker = qs::lifecycle_tracker_mt<payload, 0x5ca1e>;
+
+    // A construction, a copy and two destructions per iteration
+    constexpr size_t events_per_iteration = 4;
+
+    void churn_tracker(size_t iterations)
+    {
+        for(size_t i = 0; i < iterations; ++i)
+        {
+            tracker const a{i};
+            tracker const b{a};
+            static_cast<void>(b);
+        }
+    }
+
+    std::atomic<size_t> packed[6];
+
+    void churn_shared_atomic(size_t iterations)
+    {
+        for(size_t i = 0; i < iterations; ++i)
+        {
+            packed[0].fetch_add(1, std::memory_order_relaxed);
+            packed[1].fetch_add(1, std::memory_order_relaxed);
+            packed[5].fetch_add(1, std::memory_order_relaxed);
+            packed[5].fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    std::atomic<size_t> summed{0};
+
+    void churn_thread_local(size_t iterations)
+    {
+        size_t local[6] = {};
+        for(size_t i = 0; i < iterations; ++i)
+        {
+            ++local[0];
+            ++local[1];
+            ++local[5];
+            ++local[5];
+            // keeps the loop from folding into a single addition
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+        }
+        summed.fetch_add(local[0] + local[1] + local[5], std::memory_order_relaxed);
+    }
+
+    // Events per second over all threads
+    double run(std::function<void(size_t)> const& churn, size_t threads, size_t iterations)
+    {
+        std::atomic<size_t>      ready{0};
+        std::atomic<bool>        go{false};
+        std::vector<std::thread> workers;
+        for(size_t t = 0; t < threads; ++t)
+            workers.emplace_back(
+                [&]
+                {
+                    ready.fetch_add(1);
+                    while(!go.load())
+                        std::this_thread::yield();
+                    churn(iterations);
+                });
+        while(ready.load() != threads)
+            std::this_thread::yield();
+
+        auto const start = std::chrono::steady_clock::now();
+        go.store(true);
+        for(std::thread& worker : workers)
+            worker.join();
+        std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - start;
+        return static_cast<double>(threads * iterations * events_per_iteration) / elapsed.count();
+    }
+} // namespace
+
+
+int main(int argc, char** argv)
+{
+    size_t const max_threads =
+        argc > 1 ? std::strtoul(argv[1], nullptr, 10) : std::thread::hardware_concurrency();
+    size_t const iterations = argc > 2 ? std::strtoul(argv[2], nullptr, 10) / 4 : 1000000;
+    if(max_threads == 0 || iterations == 0)
+    {
+        std::fprintf(stderr, "usage: %s [max_threads] [events_per_thread]\n", argv[0]);
+        return 2;
+    }
+
+    tracker::set_sink(nullptr);
+
+    struct design
+    {
+        char const*                 name;
+        std::function<void(size_t)> churn;
+        bool                        thread_counters;
+    };
+    design const designs[] = {{"tracker_mt", &churn_tracker, false},
+                              {"tracker_mt_tls", &churn_tracker, true},
+                              {"shared_atomic", &churn_shared_atomic, false},
+                              {"thread_local", &churn_thread_local, false}};
+
+    std::printf("design,threads,events_per_sec,per_thread_vs_1\n");
+    for(design const& d : designs)
+    {
+        tracker::set_thread_counters_enabled(d.thread_counters);
+        double single = 0;
+        for(size_t threads = 1; threads <= max_threads; threads *= 2)
+        {
+            double const rate = run(d.churn, threads, iterations);
+            if(threads == 1)
+                single = rate;
+            std::printf("%s,%zu,%.0f,%.2f\n", d.name, threads, rate,
+                        rate / static_cast<double>(threads) / single);
+        }
+    }
+    return 0;
+}